@@ -29,7 +29,12 @@ THE SOFTWARE.
 // **** Function Artnet::Artnet() ****
 // Descr: Constructior of the call Artnet. Called once the library is loaded. Ideally to set all default values.
 // Return: A constructor does not have a return!
-Artnet::Artnet() {}
+Artnet::Artnet() : artDmxCallback(NULL), artSyncCallback(NULL), artTimeCodeCallback(NULL), cue(NULL), watch(NULL), patch(NULL), gateway(NULL), capture(NULL), sendFailures(0), queueDrops(0), dmxSequence(0), storeEnabled(false), storeDirty(false), leaseCached(false), receiveTime(0), leaseTryTime(0)
+{
+  #if defined(ARTNET_HOST)
+    shm = NULL;
+  #endif
+}
 
 // **** Function Artnet::begin(mac[], ip[]) ****
 // Descr: This function enables the Ethernet module (without DCHP) and opens the UDP port.
@@ -42,6 +47,10 @@ void Artnet::begin(byte mac[], byte ip[])
   //load the specified mac address into the node.mac[] array.
   memcpy(node.mac, mac, 6);
 
+  //Restore names and Port-Addresses, the static IP given by the user always wins over a stored lease.
+  if(storeEnabled)
+    restoreConfig();
+
   //copy the IP address to the node struct.
   for(int i=0 ; i < 4 ; i++)
         node.ip[i] = ip[i];
@@ -69,14 +78,27 @@ uint8_t Artnet::begin(byte mac[])
 
   #if !defined(ARDUINO_SAMD_ZERO) && !defined(ESP8266) && !defined(ESP32)
     Ethernet.init(ETH_CHIP_SELLECT);
+
+    //Fast boot: start on the last known lease right away, read() confirms it with DHCP once the node is idle.
+    if(storeEnabled && restoreConfig() && (stored.flags & ARTNET_STORE_LEASE))
+    {
+      Ethernet.begin(mac, IPAddress(stored.ip), IPAddress(stored.dns), IPAddress(stored.gateway), IPAddress(stored.subnet));
+      memcpy(node.ip, stored.ip, 4);
+      node.dchp = true;
+      leaseCached = true;
+      receiveTime = millis();
+      leaseTryTime = receiveTime - ARTNET_LEASE_RETRY;   //The first attempt only waits for ARTNET_LEASE_IDLE.
+
+      Udp.begin(ART_NET_PORT);
+      return 1;
+    }
+
     if(Ethernet.begin(mac)) {
       //Set DCHP true because we received an IP address.
       node.dchp = true;
       
       //Store the assigned IP address.
-      //IPAddress temp = getIP();
-      for(int i=0 ; i < 4 ; i++)
-        node.ip[i] = getIP()[i];
+      captureLease();
 
       //Now we can listen to the Art-Net port.
       Udp.begin(ART_NET_PORT);
@@ -87,6 +109,19 @@ uint8_t Artnet::begin(byte mac[])
   return 0;
 }
 
+#if defined(ARTNET_HOST)
+// **** Function Artnet::beginShared(mac[], ip[], udp) ****
+// Descr: Starts the node on a socket that is owned by someone else (see ArtnetFarm). The node does not receive by itself,
+//        packets are handed to it through read(packet, size, remoteIP). Replies are sent from ip[].
+void Artnet::beginShared(byte mac[], byte ip[], HostUDP &udp)
+{
+  loadDefaults();
+  memcpy(node.mac, mac, 6);
+  memcpy(node.ip, ip, 4);
+  Udp.share(udp, IPAddress(ip));
+}
+#endif
+
 // **** Function Artnet::beginWifi(mac[]) ****
 // Descr: This function enables the WiFi module and opens the UDP port.
 // Argumenets: mac[] = the mac address to be used. Pointer to array of 6 bytes
@@ -153,6 +188,32 @@ void Artnet::setBroadcast(IPAddress bc)
   broadcastIP = bc;
 }
 
+// **** Function Artnet::getPortAddress() ****
+// Descr: Returns the 15 bit Port-Address of port (0 to ART_NUM_UNIVERSES-1), 0xFFFF for an invalid port.
+uint16_t Artnet::getPortAddress(uint8_t port)
+{
+  if(port >= ART_NUM_UNIVERSES)
+    return 0xFFFF;
+  return node.universe[port][0];
+}
+
+// **** Function Artnet::setPortAddress() ****
+// Descr: Sets the 15 bit Port-Address of port (0 to ART_NUM_UNIVERSES-1), as ArtAddress would do.
+void Artnet::setPortAddress(uint8_t port, uint16_t portAddress)
+{
+  if(port >= ART_NUM_UNIVERSES || node.universe[port][0] == (portAddress & 0x7FFF))
+    return;
+  node.universe[port][0] = portAddress & 0x7FFF;
+  markConfigDirty();
+}
+
+// **** Function Artnet::getNodeIP() ****
+// Descr: Returns the IP address the node reports in its OpPollReply.
+IPAddress Artnet::getNodeIP()
+{
+  return IPAddress(node.ip);
+}
+
 // **** Function Artnet::read() ****
 // Descr: This function parses the received package, checks wether it is valid
 // Return:
@@ -161,137 +222,239 @@ void Artnet::setBroadcast(IPAddress bc)
 //    In all other cases 0.
 uint16_t Artnet::read()
 { 
-  if(node.dchp)
+  //A restored lease is confirmed first, after that DHCP maintains it as usual.
+  if(node.dchp && leaseCached)
+    maintainLease();
+  else if(node.dchp)
+  {
     if(maintainDCHP() != 0)
     {
       Serial.println("A DCHP rebind/renew failed!");
       return 0xFFFF;
     }
+  }
+
+  if(storeDirty)
+    maintainStore();
       
+  uint16_t result = 0;
   packetSize = Udp.parsePacket();
 
+  if(packetSize > 0)
+    receiveTime = millis();
+
   if(packetSize <= MAX_BUFFER_ARTNET && packetSize > 0)
   {
-      controllerIP = Udp.remoteIP();
-      Udp.read(artnetPacket, MAX_BUFFER_ARTNET);
+    controllerIP = Udp.remoteIP();
+    Udp.read(artnetPacket, MAX_BUFFER_ARTNET);
+    result = parsePacket();
+  }
+
+#if ARTNET_QUEUE
+  //Send a few of the queued packets between receives.
+  if(queue.count())
+    flushQueue(ARTNET_QUEUE_BATCH);
+#endif
+  return result;
+}
 
-      // Check that packetID is "Art-Net" otherwise ignore this packet
-      for (byte i = 0 ; i < 8 ; i++)
+// **** Function Artnet::read(packet, size, remoteIP) ****
+// Descr: Same as read() but for a packet that was received elsewhere, e.g. one socket shared by several nodes.
+// Argumenets: packet = the received datagram, size = its length in bytes, remoteIP = the sender of the datagram.
+// Return: see read()
+uint16_t Artnet::read(uint8_t *packet, uint16_t size, IPAddress remoteIP)
+{
+  if(storeDirty)
+    maintainStore();
+
+  if(size > MAX_BUFFER_ARTNET || size == 0)
+    return 0;
+
+  packetSize = size;
+  controllerIP = remoteIP;
+  memcpy(artnetPacket, packet, size);
+  uint16_t result = parsePacket();
+
+#if ARTNET_QUEUE
+  if(queue.count())
+    flushQueue(ARTNET_QUEUE_BATCH);
+#endif
+  return result;
+}
+
+// **** Function Artnet::parsePacket() ****
+// Descr: Checks the packet held in artnetPacket and handles its opcode.
+// Return: see read()
+uint16_t Artnet::parsePacket()
+{
+  if (capture) capture->record(artnetPacket, packetSize, controllerIP);
+
+  // Check that packetID is "Art-Net" otherwise ignore this packet
+  for (byte i = 0 ; i < 8 ; i++)
+  {
+    if (artnetPacket[i] != ART_NET_ID[i])
+      return 0;
+  }
+
+  opcode = artnetPacket[8] | artnetPacket[9] << 8;
+
+  switch(opcode) 
+  {
+    // -- OpDmc or OpOutput was received, now we need to extract the DMX date from the frame.
+    case ART_DMX:
+      if(DEBUG)
       {
-        if (artnetPacket[i] != ART_NET_ID[i])
-          return 0;
+        Serial.print("ArtDmx Received universe [");
+        Serial.print(getUniverse());
+        Serial.print("] with length of ");
+        Serial.print(getLength());
+        Serial.print("bytes. Packet sequence is: ");
+        Serial.println(getSequence());
       }
+        
+      sequence = artnetPacket[12];
+      incomingUniverse = artnetPacket[14] | artnetPacket[15] << 8;
+      dmxDataLength = artnetPacket[17] | artnetPacket[16] << 8;
 
-      opcode = artnetPacket[8] | artnetPacket[9] << 8;
+      //The length field may claim more data than was received, the rest of the buffer is from an older packet.
+      if(packetSize < ART_DMX_START)
+        return 0;
+      if(dmxDataLength > packetSize - ART_DMX_START)
+        dmxDataLength = packetSize - ART_DMX_START;
 
-      switch(opcode) 
-      {
-        // -- OpDmc or OpOutput was received, now we need to extract the DMX date from the frame.
-        case ART_DMX:
-          if(DEBUG)
-          {
-            Serial.print("ArtDmx Received universe [");
-            Serial.print(getUniverse());
-            Serial.print("] with length of ");
-            Serial.print(getLength());
-            Serial.print("bytes. Packet sequence is: ");
-            Serial.println(getSequence());
-          }
-            
-          sequence = artnetPacket[12];
-          incomingUniverse = artnetPacket[14] | artnetPacket[15] << 8;
-          dmxDataLength = artnetPacket[17] | artnetPacket[16] << 8;
-
-          if (artDmxCallback) (*artDmxCallback)(incomingUniverse, dmxDataLength, sequence, artnetPacket + ART_DMX_START, controllerIP);
-          
-          return ART_DMX;
-
-        // -- OpPoll received, now we have to respond with an OpPollReply message within 3 seconds.
-        // fill the reply struct, and then send it to the network's broadcast address
-        case ART_POLL:
-          if(DEBUG)
-            Serial.println("ArtPoll Received.");
-          if(sendPacket(ART_POLL_REPLY, controllerIP, artnetPacket, 0))
-            return ART_POLL;
-          else
-            return 0; 
+      dispatchDmx(incomingUniverse, dmxDataLength, sequence, artnetPacket + ART_DMX_START);
+      
+      return ART_DMX;
+
+    // -- OpPoll received, now we have to respond with an OpPollReply message within 3 seconds.
+    // fill the reply struct, and then send it to the network's broadcast address
+    case ART_POLL:
+      if(DEBUG)
+        Serial.println("ArtPoll Received.");
+      if(sendPacket(ART_POLL_REPLY, controllerIP, artnetPacket, 0) == 0)
+        return ART_POLL;
+      else
+        return 0; 
+
+    // -- OpSync received, this is the trigger to enable all outputs so they are syncronized. 
+    case ART_SYNC:
+      
+      dispatchSync();
+      
+      return ART_SYNC;
 
-        // -- OpSync received, this is the trigger to enable all outputs so they are syncronized. 
-        case ART_SYNC:
-          
-          if (artSyncCallback) (*artSyncCallback)(controllerIP);
-          
-          return ART_SYNC;
-        
-        // -- OpAddress received, now we have to respond with an OpPollReply message within 3 seconds with to confirm the changes.
-        case ART_ADDRESS:
+    // -- OpTimeCode received, a timecode chased cue outputs its frame for this time.
+    case ART_TIME_CODE:
+      if(packetSize < ART_SIZE_TIMECODE)
+        return 0;
+
+      timecode.stream = artnetPacket[13];
+      timecode.frames = artnetPacket[14];
+      timecode.seconds = artnetPacket[15];
+      timecode.minutes = artnetPacket[16];
+      timecode.hours = artnetPacket[17];
+      timecode.type = artnetPacket[18];
+
+      if (artTimeCodeCallback) (*artTimeCodeCallback)(&timecode, controllerIP);
+      if (cue && cue->chase(&timecode)) playCue();
+
+      return ART_TIME_CODE;
+    
+    // -- OpAddress received, now we have to respond with an OpPollReply message within 3 seconds with to confirm the changes.
+    case ART_ADDRESS:
+    {
+      if(DEBUG)
+        Serial.println("ArtAddress Received.");
+      //Every OpPollReply describes one port, so the BindIndex selects the universe. 0 and 1 both address the root.
+      uint8_t bindIndex = (artnetPacket[13] > 0) ? artnetPacket[13]-1 : 0;
+
+      //Update port address: a switch is only programmed when its bit 7 is set.
+      if(bindIndex < ART_NUM_UNIVERSES)
+      {
+        uint16_t tempPortAddr = node.universe[bindIndex][0];
+        if(artnetPacket[12] & 0x80)                                 //Net switch :: bits 14 to 8
+          tempPortAddr = (tempPortAddr & 0x00FF) | ((uint16_t)(artnetPacket[12] & 0x7F) << 8);
+        if(artnetPacket[104] & 0x80)                                //SubNet switch :: bits 7 to 4
+          tempPortAddr = (tempPortAddr & 0x7F0F) | ((artnetPacket[104] & 0x0F) << 4);
+
+        //if universe is input then look at Swin array, otherwise at the Swout array
+        uint8_t sw = (node.universe[bindIndex][1] == 1) ? artnetPacket[96] : artnetPacket[100];
+        if(sw & 0x80)
+          tempPortAddr = (tempPortAddr & 0x7FF0) | (sw & 0x0F);
+
+        if(tempPortAddr != node.universe[bindIndex][0])
         {
-          if(DEBUG)
-            Serial.println("ArtAddress Received.");
-          uint8_t bindIndex = artnetPacket[13]-1; 
-          //Update port address:
-          uint16_t tempPortAddr = 0;
-          tempPortAddr |= (0x007F && artnetPacket[12]) << 8;
-          tempPortAddr |= 0x00F0 && artnetPacket[104];
-          
-          for(int j=0 ; j < 4 ; j++) 
-          {
-            if((bindIndex*4)+j < ART_NUM_UNIVERSES)
-             {
-                if(node.universe[(bindIndex*4)+j][1] == 1 && j < 4)     //if universe is input then look at Swin array
-                  tempPortAddr |= (0x000F && artnetPacket[96+j]);
-                else                                                    //if universe is output then look at Swout array
-                  tempPortAddr |= (0x000F && artnetPacket[100+j]);
-      
-                node.universe[(bindIndex*4)+j][0] = tempPortAddr; 
-             }  
-          }
-
-          //ShortName Field:
-          boolean areEquel = false;
-          for(int x=0 ; x < 18 ; x++)
-          {
-            if(node.shortname[x] == artnetPacket[14+x])
-              areEquel = true;
-          }
-          if(areEquel)
-          {
-            setShortDescr((char*)&artnetPacket[14]);
-            node.nodeReportCode = RC_SHNAME_OK;
-          }
-
-          //LongName Field:
-          areEquel = false;
-          for(int x=0 ; x < 18 ; x++)
-          {
-            if(node.longname[x] == artnetPacket[32+x])
-              areEquel = true;
-          }
-          if(areEquel)
-          {
-            setShortDescr((char*)&artnetPacket[32]);
-            node.nodeReportCode = RC_LONAME_OK;
-          }
-                  
-          //Set Command Field and send out the reply to the controller. (artnetPacket[106])
-          if(sendPacket(ART_POLL_REPLY, controllerIP, artnetPacket, 0))
-            return ART_ADDRESS | (0x00FF & setCmd(artnetPacket[106]));
-          else
-            return 0;
+          node.universe[bindIndex][0] = tempPortAddr;
+          markConfigDirty();
         }
-        default:
-          if(DEBUG) {
-            Serial.print("An unsupported Art-Net opcode was recieved: 0x");
-            Serial.println(opcode, HEX);
-          }  
-          return 0;
       }
+
+      //ShortName Field: a null string means no change.
+      if(artnetPacket[14] != 0)
+      {
+        setShortDescr((char*)&artnetPacket[14]);
+        node.nodeReportCode = RC_SHNAME_OK;
+      }
+
+      //LongName Field: a null string means no change.
+      if(artnetPacket[32] != 0)
+      {
+        setLongDescr((char*)&artnetPacket[32]);
+        node.nodeReportCode = RC_LONAME_OK;
+      }
+              
+      //Set Command Field and send out the reply to the controller. (artnetPacket[106])
+      if(sendPacket(ART_POLL_REPLY, controllerIP, artnetPacket, 0) == 0)
+        return ART_ADDRESS | (0x00FF & setCmd(artnetPacket[106]));
+      else
+        return 0;
+    }
+    default:
+      if(DEBUG) {
+        Serial.print("An unsupported Art-Net opcode was recieved: 0x");
+        Serial.println(opcode, HEX);
+      }  
+      return 0;
   }
-  else
+  return 0;
+}
+
+// **** Function Artnet::dispatchDmx() ****
+// Descr: Hands the DMX data of a universe to the callback and all attached outputs.
+void Artnet::dispatchDmx(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *data)
+{
+  if (artDmxCallback) (*artDmxCallback)(universe, length, sequence, data, controllerIP);
+  if (gateway) gateway->forward(universe, length, data);
+  if (patch) patch->apply(universe, length, data);
+  if (watch) watch->update(universe, length, data);
+#if defined(ARTNET_HOST)
+  if (shm) shm->update(universe, length, sequence, data);
+#endif
+}
+
+// **** Function Artnet::dispatchSync() ****
+// Descr: Passes an ArtSync to the callback and all attached outputs.
+void Artnet::dispatchSync()
+{
+  if (gateway) gateway->sync();
+#if defined(ARTNET_HOST)
+  if (shm) shm->sync();
+#endif
+  if (artSyncCallback) (*artSyncCallback)(controllerIP);
+}
+
+// **** Function Artnet::playCue() ****
+// Descr: Outputs every universe of the cue's current frame as if it was received as ArtDmx, followed by an ArtSync
+//        so synchronous outputs show the whole frame at once.
+void Artnet::playCue()
+{
+  for(uint16_t i=0 ; i < cue->getUniverses() ; i++)
   {
-    return 0;
+    const uint8_t *data = cue->getData(i);
+    if(data)
+      dispatchDmx(cue->getUniverse(i), cue->getLength(), 0, (uint8_t*)data);
   }
-  return 0;
+  dispatchSync();
 }
 
 void Artnet::printPacketHeader()
@@ -324,8 +487,9 @@ void Artnet::printPacketContent()
 //            *data = pointer to a data buffer (for future expension, this to enable to send ArtDmx packages)
 //            datasize = defines the size of the to tranfer buffer. (for future expension)
 //    
-// Return:  0 = UDP packet was send succesfully
-//          1 = UDP packet was not send out for some reason
+// Return:  0 = UDP packet was queued succesfully, read() sends it (sent succesfully when ARTNET_QUEUE is 0)
+//          1 = UDP packet was not queued, the send queue can not hold the whole answer and none of it was queued
+//              (not sent when ARTNET_QUEUE is 0)
 uint8_t Artnet::sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *data, uint16_t datasize)
 {
   uint8_t packetsize = 0;
@@ -338,6 +502,14 @@ uint8_t Artnet::sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *da
   {
     // -- OpPollReply
     case ART_POLL_REPLY:
+    #if ARTNET_QUEUE
+      //Queue the answer for every port or none of it, a controller would show a node with missing ports.
+      if(queue.available(ARTNET_QUEUE_REPLY) < ART_NUM_UNIVERSES)
+      {
+        queueDrops += ART_NUM_UNIVERSES;
+        return 1;
+      }
+    #endif
       for(uint16_t univ=0 ; univ < ART_NUM_UNIVERSES ; univ++) {
         // Set the size of the packet to send, relevant to send out the packet.
         packetsize = ART_SIZE_POLLREPLY;
@@ -358,8 +530,8 @@ uint8_t Artnet::sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *da
           packet[17] = node.version;
 
           //Net and Sub switch are part of the Port-Address
-          packet[18] = (uint8_t)(node.universe[univ][0] & 0x7F00) >> 8;       //Net switch :: Only bits 14 to 8 are relevant and should be placed in this byte.
-          packet[19] = (uint8_t)(node.universe[univ][0] & 0x00F0) >> 4;       //SubNet switch :: Only bits 7 to 4 are relevant and should be placed in this byte.
+          packet[18] = (uint8_t)((node.universe[univ][0] & 0x7F00) >> 8);     //Net switch :: Only bits 14 to 8 are relevant and should be placed in this byte.
+          packet[19] = (uint8_t)((node.universe[univ][0] & 0x00F0) >> 4);     //SubNet switch :: Only bits 7 to 4 are relevant and should be placed in this byte.
 
           //Satus1 field
             // bit0 =1 UBEA present. ;; =0 UBEA not present or corrupt
@@ -399,14 +571,17 @@ uint8_t Artnet::sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *da
           packet[174] |= node.universe[univ][2];                       // Set the used protol.
 
           //Good input / good output
-          packet[178] |= (node.universe[univ][3] >> 8);               //Upper byte represents good input
-          packet[172] |= node.universe[univ][3];                      //Lower byte represents good output
+          //The packet buffer is reused for every universe, so these fields are assigned rather than or-ed.
+          packet[178] = (node.universe[univ][3] >> 8);                //Upper byte represents good input
+          packet[182] = (uint8_t)node.universe[univ][3];              //Lower byte represents good output
         
           //Set Swin/Swout values
+          packet[186] = 0;
+          packet[190] = 0;
           if(node.universe[univ][1] == 1)                              //if the universe is an input universe then swin is set otherwise swout
-            packet[186] |= (node.universe[univ][3] & 0x0F);           //Swin bits 3-0 represent a part of the 15 bits port address.
+            packet[186] = (node.universe[univ][0] & 0x0F);            //Swin bits 3-0 represent a part of the 15 bits port address.
           else
-            packet[190] |= (node.universe[univ][3] & 0x0F);           //Swout bits 3-0 represent a part of the 15 bits port address.
+            packet[190] = (node.universe[univ][0] & 0x0F);            //Swout bits 3-0 represent a part of the 15 bits port address.
 
           //set the style of the node
           packet[200] = node.style;
@@ -451,13 +626,145 @@ uint8_t Artnet::sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *da
 }
 
 // **** Function Artnet::transderPacket() ****
-// Descr: This function generates the packets and sends to the controller
-// Return: 1 = success , 0 = fail
+// Descr: This function queues a reply packet, it is sent out from read() so the caller does not wait for the network.
+//        When ARTNET_QUEUE is 0 the packet is sent on the spot.
+// Return: 1 = success , 0 = fail (the queue is full or the packet was not sent)
 uint8_t Artnet::transferPacket(IPAddress destinationIP, uint8_t *packet, uint16_t size) 
 {
-  Udp.beginPacket(destinationIP, ART_NET_PORT);
-  Udp.write((uint8_t *)packet, size);
-  return Udp.endPacket(); 
+#if ARTNET_QUEUE
+  if(queue.push(ARTNET_QUEUE_REPLY, destinationIP, packet, size))
+    return 1;
+  queueDrops++;
+  return 0;
+#else
+  return sendDatagram(destinationIP, packet, size);
+#endif
+}
+
+// **** Function Artnet::sendDmx() ****
+// Descr: Queues an ArtDmx packet for universe, it is sent out from read() like the replies of the node.
+//        When ARTNET_QUEUE is 0 the packet is sent on the spot.
+// Argumenets: universe = 15 bit Port-Address, length = number of channels (2 to 512, odd lengths are padded),
+//             data = the DMX data, ip = the receiving node or the broadcast address.
+// Return: 1 = queued (sent) ; 0 = the DMX queue is full, the node report code is set to RC_DMX_TX_FULL (not sent).
+uint8_t Artnet::sendDmx(uint16_t universe, uint16_t length, uint8_t *data, IPAddress ip)
+{
+  if(length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS;
+  uint16_t slots = (length < 2) ? 2 : (length + 1) & ~1;
+
+#if ARTNET_QUEUE
+  uint8_t *packet = queue.reserve(ARTNET_QUEUE_DATA);
+  if(!packet)
+  {
+    queueDrops++;
+    node.nodeReportCode = RC_DMX_TX_FULL;
+    return 0;
+  }
+#else
+  uint8_t packet[ART_SIZE_DMX];
+#endif
+
+  //Sequence 0 disables sequencing at the receiver, so it counts from 1 to 255.
+  if(++dmxSequence == 0)
+    dmxSequence = 1;
+
+  memcpy(packet, ART_NET_ID, 8);
+  packet[ART_NET_OP_OFFSET] = (uint8_t)ART_DMX;
+  packet[ART_NET_OP_OFFSET+1] = (uint8_t)(ART_DMX >> 8);
+  packet[10] = 0;                                   //ProtVerHi
+  packet[11] = ART_NET_VERSION;                     //ProtVerLo
+  packet[12] = dmxSequence;
+  packet[13] = 0;                                   //Physical
+  packet[14] = (uint8_t)universe;                   //SubUni
+  packet[15] = (uint8_t)(universe >> 8) & 0x7F;     //Net
+  packet[16] = slots >> 8;
+  packet[17] = (uint8_t)slots;
+  memcpy(packet + ART_DMX_START, data, length);
+  if(slots != length)
+    memset(packet + ART_DMX_START + length, 0, slots - length);
+
+#if ARTNET_QUEUE
+  queue.commit(ARTNET_QUEUE_DATA, ip, ART_DMX_START + slots);
+  return 1;
+#else
+  return sendDatagram(ip, packet, ART_DMX_START + slots);
+#endif
+}
+
+// **** Function Artnet::flush() ****
+// Descr: Sends all queued packets now instead of a few per read(), e.g. before going to sleep.
+void Artnet::flush()
+{
+#if ARTNET_QUEUE
+  while(flushQueue(ARTNET_QUEUE_BATCH))
+    ;
+#endif
+}
+
+#if ARTNET_QUEUE
+// **** Function Artnet::flushQueue() ****
+// Descr: Sends up to max queued packets, one sendmmsg() call on the Linux host. Failed sends are counted and set the
+//        node report code: RC_UDP_FAIL when the socket could not be used, RC_SOCKET_WR1 when the datagram was not sent.
+// Return: the number of packets taken off the queue.
+uint8_t Artnet::flushQueue(uint8_t max)
+{
+  struct queuePacket_s *batch[ARTNET_QUEUE_BATCH];
+  if(max > ARTNET_QUEUE_BATCH)
+    max = ARTNET_QUEUE_BATCH;
+
+  uint8_t n = queue.pop(batch, max);
+
+  #if defined(ARTNET_HOST)
+    IPAddress ips[ARTNET_QUEUE_BATCH];
+    uint8_t *buffers[ARTNET_QUEUE_BATCH];
+    uint16_t sizes[ARTNET_QUEUE_BATCH];
+    for(uint8_t i=0 ; i < n ; i++)
+    {
+      ips[i] = batch[i]->ip;
+      buffers[i] = batch[i]->data;
+      sizes[i] = batch[i]->size;
+    }
+
+    int sent = n ? Udp.sendBatch(ips, ART_NET_PORT, buffers, sizes, n) : 0;
+    if(sent < 0)
+    {
+      sendFailures += n;
+      node.nodeReportCode = RC_UDP_FAIL;
+    }
+    else if(sent < n)
+    {
+      sendFailures += n - sent;
+      node.nodeReportCode = RC_SOCKET_WR1;
+    }
+  #else
+    for(uint8_t i=0 ; i < n ; i++)
+      sendDatagram(batch[i]->ip, batch[i]->data, batch[i]->size);
+  #endif
+  return n;
+}
+#endif
+
+// **** Function Artnet::sendDatagram() ****
+// Descr: Sends one packet on the spot. A failed send is counted and sets the node report code: RC_UDP_FAIL when the
+//        socket could not be used, RC_SOCKET_WR1 when the datagram was not sent.
+// Return: 1 = sent ; 0 = fail
+uint8_t Artnet::sendDatagram(IPAddress destinationIP, uint8_t *packet, uint16_t size)
+{
+  if(!Udp.beginPacket(destinationIP, ART_NET_PORT))
+  {
+    sendFailures++;
+    node.nodeReportCode = RC_UDP_FAIL;
+    return 0;
+  }
+  Udp.write(packet, size);
+  if(!Udp.endPacket())
+  {
+    sendFailures++;
+    node.nodeReportCode = RC_SOCKET_WR1;
+    return 0;
+  }
+  return 1;
 }
 
 // **** Function setNodeReportMsg(char msg[]) ****
@@ -495,9 +802,7 @@ uint16_t Artnet::maintainDCHP()
     case 2:
     case 4:
     { 
-      //IPAddress temp = getIP();
-      for(int i=0 ; i < 4 ; i++)
-        node.ip[i] = getIP()[i];
+      captureLease();
       return 0;
     }
     case 0:
@@ -549,7 +854,14 @@ void Artnet::loadDefaults()
 // NOTE: Respect the max length of the field. It is only 18 ASCI characters.
 void Artnet::setShortDescr(char *sname) 
 {
+  char name[sizeof(node.shortname)] = {0};
+  strncpy(name, sname, sizeof(name)-1);
 
+  if(memcmp(node.shortname, name, sizeof(name)) != 0)
+  {
+    memcpy(node.shortname, name, sizeof(name));
+    markConfigDirty();
+  }
 }
 
 // **** Function Artnet::setLongDescr() ****
@@ -557,7 +869,14 @@ void Artnet::setShortDescr(char *sname)
 // NOTE: Respect the max length of the field. It is only 64 ASCI characters.
 void Artnet::setLongDescr(char *lname) 
 {
+  char name[sizeof(node.longname)] = {0};
+  strncpy(name, lname, sizeof(name)-1);
 
+  if(memcmp(node.longname, name, sizeof(name)) != 0)
+  {
+    memcpy(node.longname, name, sizeof(name));
+    markConfigDirty();
+  }
 }
 
 // **** Function Artnet::setCmd() ****
@@ -591,3 +910,183 @@ uint8_t Artnet::setCmd(uint8_t cmd)
     return cmd;
   }
 }
+
+// **** Function Artnet::beginStore() ****
+// Descr: Enables the persistent configuration. Call this before begin(), which then restores the names, Port-Addresses
+//        and last DHCP lease. With a stored lease begin(mac) returns immediately. read() confirms the lease with DHCP
+//        once no packets arrived for ARTNET_LEASE_IDLE (see maintainLease()), or the sketch calls confirmLease().
+// Argumenets: address = EEPROM offset of the record (ignored for the file backend).
+// Return: 1 = storage available ; 0 = storage not supported on this platform.
+uint8_t Artnet::beginStore(uint16_t address)
+{
+  storeEnabled = store.begin(address, sizeof(stored));
+  memset(&stored, 0, sizeof(stored));
+  return storeEnabled;
+}
+
+// **** Function Artnet::restoreConfig() ****
+// Descr: Loads the stored record and applies the names and Port-Addresses to the node.
+// Return: 1 = a valid record was restored ; 0 = nothing stored or the record is corrupt/outdated.
+uint8_t Artnet::restoreConfig()
+{
+  struct store_s rec;
+  if(!store.read((uint8_t*)&rec))
+    return 0;
+  if(rec.magic != ARTNET_STORE_MAGIC || rec.layout != ARTNET_STORE_LAYOUT)
+    return 0;
+  if(rec.crc != artnetCrc16((uint8_t*)&rec, offsetof(store_s, crc)))
+    return 0;
+
+  stored = rec;
+  memcpy(node.shortname, rec.shortname, sizeof(node.shortname));
+  memcpy(node.longname, rec.longname, sizeof(node.longname));
+  node.shortname[sizeof(node.shortname)-1] = 0;
+  node.longname[sizeof(node.longname)-1] = 0;
+
+  //Only address, direction and protocol are configuration, the status field restarts from its default.
+  for(int i=0 ; i < ART_NUM_UNIVERSES ; i++)
+    for(int j=0 ; j < 3 ; j++)
+      node.universe[i][j] = rec.universe[i][j];
+
+  return 1;
+}
+
+// **** Function Artnet::saveConfig() ****
+// Descr: Writes the current configuration. Nothing is written when it equals the stored record.
+// Return: 1 = the store holds the current configuration ; 0 = store disabled or write failed.
+uint8_t Artnet::saveConfig()
+{
+  if(!storeEnabled)
+    return 0;
+
+  storeDirty = false;
+
+  struct store_s rec = stored;   //Keeps the last lease when running on a static IP.
+  rec.magic = ARTNET_STORE_MAGIC;
+  rec.layout = ARTNET_STORE_LAYOUT;
+  memcpy(rec.shortname, node.shortname, sizeof(rec.shortname));
+  memcpy(rec.longname, node.longname, sizeof(rec.longname));
+  //The status field is runtime state and not stored, see restoreConfig().
+  for(int i=0 ; i < ART_NUM_UNIVERSES ; i++)
+    for(int j=0 ; j < 3 ; j++)
+      rec.universe[i][j] = node.universe[i][j];
+
+  #if !defined(ARDUINO_SAMD_ZERO) && !defined(ESP8266) && !defined(ESP32)
+    if(node.dchp && !leaseCached)
+    {
+      rec.flags |= ARTNET_STORE_LEASE;
+      for(int i=0 ; i < 4 ; i++)
+      {
+        rec.ip[i]      = Ethernet.localIP()[i];
+        rec.subnet[i]  = Ethernet.subnetMask()[i];
+        rec.gateway[i] = Ethernet.gatewayIP()[i];
+        rec.dns[i]     = Ethernet.dnsServerIP()[i];
+      }
+    }
+  #endif
+
+  rec.crc = artnetCrc16((uint8_t*)&rec, offsetof(store_s, crc));
+  if(memcmp(&rec, &stored, sizeof(rec)) == 0)
+    return 1;
+
+  if(!store.write((uint8_t*)&rec))
+    return 0;
+
+  stored = rec;
+  return 1;
+}
+
+// **** Function Artnet::clearConfig() ****
+// Descr: Invalidates the stored record, the next boot starts from the defaults and a fresh DHCP lease.
+void Artnet::clearConfig()
+{
+  if(!storeEnabled)
+    return;
+
+  struct store_s rec;
+  memset(&rec, 0, sizeof(rec));
+  if(store.write((uint8_t*)&rec))
+    stored = rec;
+  storeDirty = false;
+}
+
+// **** Function Artnet::markConfigDirty() ****
+// Descr: Flags a configuration change. The write is deferred so a burst of ArtAddress packets ends up in one write.
+void Artnet::markConfigDirty()
+{
+  if(!storeEnabled)
+    return;
+
+  storeDirty = true;
+  storeDirtyTime = millis();
+}
+
+// **** Function Artnet::maintainStore() ****
+// Descr: Commits a pending configuration change once it has been stable for ARTNET_STORE_DELAY.
+void Artnet::maintainStore()
+{
+  if(millis() - storeDirtyTime >= ARTNET_STORE_DELAY)
+    saveConfig();
+}
+
+// **** Function Artnet::captureLease() ****
+// Descr: Copies the IP assigned by DHCP into the node and flags the lease for storage when it changed.
+void Artnet::captureLease()
+{
+  IPAddress ip = getIP();
+  uint8_t changed = 0;
+  for(int i=0 ; i < 4 ; i++)
+  {
+    if(node.ip[i] != ip[i])
+      changed = 1;
+    node.ip[i] = ip[i];
+  }
+
+  if(changed || !(stored.flags & ARTNET_STORE_LEASE))
+    markConfigDirty();
+}
+
+// **** Function Artnet::confirmLease() ****
+// Descr: While running on a restored lease, tries DHCP once with a short timeout (ARTNET_LEASE_TIMEOUT).
+//        This BLOCKS and resets the Ethernet chip, so no packets are received meanwhile. read() calls it when the node
+//        is idle, a sketch may call it earlier when blocking is acceptable. When DHCP does not answer the node goes
+//        back to the cached lease and keeps running.
+// Return: 0 = DHCP confirmed the lease (or no cached lease is used) ; 1 = still running on the cached lease.
+uint16_t Artnet::confirmLease()
+{
+  if(!leaseCached)
+    return 0;
+
+  #if !defined(ARDUINO_SAMD_ZERO) && !defined(ESP8266) && !defined(ESP32)
+    if(Ethernet.begin(node.mac, ARTNET_LEASE_TIMEOUT, ARTNET_LEASE_RESPONSE))
+    {
+      leaseCached = false;
+      captureLease();
+    }
+    else
+      Ethernet.begin(node.mac, IPAddress(stored.ip), IPAddress(stored.dns), IPAddress(stored.gateway), IPAddress(stored.subnet));
+
+    //The chip was re-initialised by the DHCP attempt, so the socket has to be opened again.
+    Udp.begin(ART_NET_PORT);
+    return leaseCached ? 1 : 0;
+  #else
+    leaseCached = false;
+    return 0;
+  #endif
+}
+
+// **** Function Artnet::maintainLease() ****
+// Descr: Confirms a restored lease from read(). The blocking DHCP attempt waits until no packet was received for
+//        ARTNET_LEASE_IDLE, so it does not interrupt a show, and is repeated every ARTNET_LEASE_RETRY while DHCP does
+//        not answer. Without confirmation the node would keep the address after the lease expired.
+void Artnet::maintainLease()
+{
+#if ARTNET_LEASE_IDLE
+  uint32_t now = millis();
+  if(now - receiveTime < ARTNET_LEASE_IDLE || now - leaseTryTime < ARTNET_LEASE_RETRY)
+    return;
+
+  leaseTryTime = now;
+  confirmLease();
+#endif
+}
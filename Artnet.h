@@ -30,9 +30,16 @@ THE SOFTWARE.
 #ifndef ARTNET_H
 #define ARTNET_H
 
-#include <Arduino.h>
+#if defined(__linux__) && !defined(ARDUINO)
+    #define ARTNET_HOST
+    #define ARTNET_STORE_FILE
+#else
+    #include <Arduino.h>
+#endif
 
-#if defined(ARDUINO_SAMD_ZERO)    //UNTESTED!
+#if defined(ARTNET_HOST)          //Linux host, see ArtnetHost.h
+    #include <ArtnetHost.h>
+#elif defined(ARDUINO_SAMD_ZERO)    //UNTESTED!
     #include <WiFi101.h>
     #include <WiFiUdp.h>
 #elif defined(ESP8266)            //UNTESTED!
@@ -71,8 +78,10 @@ const char   defaultLongname[64]  = "Open source Arduino node\0";
 #define   ART_NET_OP_OFFSET       8
 #define   ART_NET_ID              "Art-Net\0" //Every Art-Net package is obligate to carry the packet ID ‘A’ ‘r’ ‘t’ ‘-‘ ‘N’ ‘e’ ‘t’ 0x00
 #define   ART_DMX_START           18          //Start byte of the DMX data in the ArtDmx packet.
+#define   ARTNET_DMX_CHANNELS     512         //Maximum number of DMX channels in a universe.
 #define   ART_SIZE_POLLREPLY      238         //Size in bytes of the OpPollReply message
 #define   ART_SIZE_DMX            530         //Size in bytes of the OpPollReply message
+#define   ART_SIZE_TIMECODE       19          //Size in bytes of the OpTimeCode message
 #define   ART_NUM_UNIVERSES       4
 #define   ART_UNIVERSE_PARAMS     4
 
@@ -165,6 +174,35 @@ struct node_s {
   uint16_t    universe[ART_NUM_UNIVERSES][ART_UNIVERSE_PARAMS];     //PARAMS: 0 = universe address (0 to 32768) ;; 1 = direction (0 equals output ~ 1 equals input) ;; 2 = protocol (0 is DMX, 5 Art-Net, ... ) ;; 3 = status field refer to goodInput/output
 };
 
+struct timecode_s {
+  uint8_t     frames;                         //0 to 23, 24, 29 depending on type.
+  uint8_t     seconds;
+  uint8_t     minutes;
+  uint8_t     hours;
+  uint8_t     type;                           //0 = Film (24fps) ;; 1 = EBU (25fps) ;; 2 = DF (29.97fps) ;; 3 = SMPTE (30fps)
+  uint8_t     stream;                         //Stream id, 0 = master.
+};
+
+#include <ArtnetStore.h>
+#include <ArtnetWatch.h>
+#include <ArtnetOcto.h>
+#include <ArtnetPatch.h>
+#include <ArtnetSacn.h>
+#include <ArtnetCapture.h>
+#include <ArtnetShm.h>
+#include <ArtnetCue.h>
+#include <ArtnetQueue.h>
+
+// *** Fast boot: a node that booted from a cached lease confirms it from read() once idle, or with confirmLease().
+#define ARTNET_LEASE_TIMEOUT      1500        // ms a single DHCP attempt of confirmLease() may take.
+#define ARTNET_LEASE_RESPONSE     500         // ms to wait for each DHCP response.
+#ifndef ARTNET_LEASE_IDLE
+  #define ARTNET_LEASE_IDLE       2000        // ms without received packets before read() confirms the lease, 0 = never.
+#endif
+#ifndef ARTNET_LEASE_RETRY
+  #define ARTNET_LEASE_RETRY      60000       // ms between the attempts of read() while DHCP does not answer.
+#endif
+
 class Artnet
 {
   public:
@@ -176,6 +214,7 @@ class Artnet
       void setBroadcast(byte bc[]);
       void setBroadcast(IPAddress bc);
       uint16_t read(void);
+      uint16_t read(uint8_t *packet, uint16_t size, IPAddress remoteIP);
       void printPacketHeader(void);
       void printPacketContent(void);
       IPAddress getIP(void);
@@ -183,6 +222,18 @@ class Artnet
       void clearNodeReportMsg();
       void setShortDescr(char *sname);
       void setLongDescr(char *lname);
+      uint8_t beginStore(uint16_t address = ARTNET_STORE_ADDR);
+      uint8_t saveConfig(void);
+      void clearConfig(void);
+      uint16_t getPortAddress(uint8_t port);
+      void setPortAddress(uint8_t port, uint16_t portAddress);
+      IPAddress getNodeIP(void);
+      uint16_t confirmLease(void);
+      uint8_t sendDmx(uint16_t universe, uint16_t length, uint8_t *data, IPAddress ip);
+      void flush(void);
+    #if defined(ARTNET_HOST)
+      void beginShared(byte mac[], byte ip[], HostUDP &udp);
+    #endif
   
     // **** Function Artnet::setgetDmxFrame() ****
     // Descr: This function allows the user to get the pointer to the DMX data
@@ -226,6 +277,28 @@ class Artnet
       return controllerIP;
     }
 
+    // **** Function Artnet::isLeaseCached() ****
+    // Descr: True while the node runs on a restored lease that DHCP did not confirm yet, see beginStore() and confirmLease().
+    inline bool isLeaseCached(void)
+    {
+      return leaseCached;
+    }
+
+    // **** Function Artnet::getSendFailures() ****
+    // Descr: This function returns the number of packets the network refused to send.
+    inline uint32_t getSendFailures(void)
+    {
+      return sendFailures;
+    }
+
+    // **** Function Artnet::getQueueDrops() ****
+    // Descr: This function returns the number of packets that were dropped because the send queue was full. A poll answer
+    //        that does not fit as a whole is dropped and counts as ART_NUM_UNIVERSES packets.
+    inline uint32_t getQueueDrops(void)
+    {
+      return queueDrops;
+    }
+
     // **** Function Artnet::setArtDmxCallback() ****
     // Descr: ---
     inline void setArtDmxCallback(void (*fptr)(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t* data, IPAddress IPAddr))
@@ -240,6 +313,64 @@ class Artnet
       artSyncCallback = fptr;
     }
 
+    // **** Function Artnet::setArtTimeCodeCallback() ****
+    // Descr: This function sets the rountine that is to be called once an OpTimeCode was received.
+    inline void setArtTimeCodeCallback(void (*fptr)(struct timecode_s *tc, IPAddress IPAddr))
+    {
+      artTimeCodeCallback = fptr;
+    }
+
+    // **** Function Artnet::getTimeCode() ****
+    // Descr: This function returns the last received timecode
+    inline struct timecode_s getTimeCode(void)
+    {
+      return timecode;
+    }
+
+    // **** Function Artnet::setCue() ****
+    // Descr: Attaches timecode chased playback, on every ArtTimeCode the cue's frame is output as ArtDmx and ArtSync. NULL detaches it.
+    inline void setCue(ArtnetCue *c)
+    {
+      cue = c;
+    }
+
+    // **** Function Artnet::setWatch() ****
+    // Descr: Attaches change detection, every ArtDmx packet is passed to watch->update(). NULL detaches it.
+    inline void setWatch(ArtnetWatch *w)
+    {
+      watch = w;
+    }
+
+    // **** Function Artnet::setPatch() ****
+    // Descr: Attaches a compiled patch map, every ArtDmx packet is copied to its output with patch->apply(). NULL detaches it.
+    inline void setPatch(ArtnetPatch *p)
+    {
+      patch = p;
+    }
+
+    // **** Function Artnet::setGateway() ****
+    // Descr: Attaches an sACN gateway, every ArtDmx is forwarded as E1.31 and ArtSync as E1.31 synchronization. NULL detaches it.
+    inline void setGateway(ArtnetSacn *g)
+    {
+      gateway = g;
+    }
+
+    // **** Function Artnet::setCapture() ****
+    // Descr: Attaches a black-box capture, every received datagram is recorded with capture->record(). NULL detaches it.
+    inline void setCapture(ArtnetCapture *c)
+    {
+      capture = c;
+    }
+
+  #if defined(ARTNET_HOST)
+    // **** Function Artnet::setShm() ****
+    // Descr: Attaches a shared memory export, ArtDmx is published with shm->update() and ArtSync commits the frame. NULL detaches it.
+    inline void setShm(ArtnetShm *s)
+    {
+      shm = s;
+    }
+  #endif
+
 /*     // **** Function Artnet::getDchpStatus() ****
     // Descr: Returns current dchp status.
     inline uint16_t getDchpStatus(void)
@@ -250,6 +381,8 @@ class Artnet
   private:
     #if defined(ARDUINO_SAMD_ZERO) || defined(ESP8266) || defined(ESP32)
       WiFiUDP Udp;
+    #elif defined(ARTNET_HOST)
+      HostUDP Udp;
     #else
       EthernetUDP Udp;
     #endif
@@ -271,12 +404,53 @@ class Artnet
 
     void (*artDmxCallback)(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t* data, IPAddress IPAddr);
     void (*artSyncCallback)(IPAddress IPAddr);
+    void (*artTimeCodeCallback)(struct timecode_s *tc, IPAddress IPAddr);
+    struct timecode_s timecode;
+    ArtnetCue   *cue;
+    ArtnetWatch *watch;
+    ArtnetPatch *patch;
+    ArtnetSacn  *gateway;
+    ArtnetCapture *capture;
+  #if defined(ARTNET_HOST)
+    ArtnetShm   *shm;
+  #endif
     uint8_t sendPacket(uint16_t opcode, IPAddress destinationIP, uint8_t *data, uint16_t datasize);
     uint8_t transferPacket(IPAddress destinationIP, uint8_t *packet, uint16_t size);
+    uint8_t sendDatagram(IPAddress destinationIP, uint8_t *packet, uint16_t size);
+  #if ARTNET_QUEUE
+    uint8_t flushQueue(uint8_t max);
+  #endif
+    uint16_t parsePacket();
+    void dispatchDmx(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *data);
+    void dispatchSync();
+    void playCue();
     void sendArtPollReply();
     uint16_t maintainDCHP();
     uint8_t  setCmd(uint8_t cmd);
     void loadDefaults();
+
+  #if ARTNET_QUEUE
+    // Outbound packets wait here until read() sends them, see ArtnetQueue.h.
+    ArtnetQueue queue;
+  #endif
+    uint32_t  sendFailures;
+    uint32_t  queueDrops;
+    uint8_t   dmxSequence;
+
+    // Persistent configuration, see beginStore().
+    ArtnetStore store;
+    struct store_s stored;          //Image of the record as it is currently kept in the store.
+    bool      storeEnabled;
+    bool      storeDirty;
+    uint32_t  storeDirtyTime;
+    bool      leaseCached;          //True while running on a restored lease that DHCP did not confirm yet.
+    uint32_t  receiveTime;          //Last packet received by read().
+    uint32_t  leaseTryTime;         //Last DHCP attempt made by read() on the restored lease.
+    uint8_t  restoreConfig();
+    void     markConfigDirty();
+    void     maintainStore();
+    void     captureLease();
+    void     maintainLease();
     
 };
 
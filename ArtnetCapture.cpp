@@ -0,0 +1,314 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+#if defined(ARTNET_HOST)
+  #include <sys/time.h>
+#endif
+
+#define ARTNET_PCAP_LINKTYPE_IPV4   228     // Records start with the IPv4 header.
+#define ARTNET_PCAP_HEADERS         28      // Synthesised IPv4 and UDP header in front of every datagram.
+
+static inline void capturePutLe32(uint8_t *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static inline void capturePutBe16(uint8_t *p, uint16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v;
+}
+
+ArtnetCapture::ArtnetCapture() : events(ARTNET_CAPTURE_ON_GAP), postRecords(ARTNET_CAPTURE_RECORDS / 2)
+{
+  arm();
+}
+
+// **** Function ArtnetCapture::setTrigger() ****
+// Descr: Selects the events that fire the trigger (ARTNET_CAPTURE_ON_GAP or 0 for trigger() only) and how many records
+//        are still kept after it fired, so the ring holds what happened before and after the event.
+void ArtnetCapture::setTrigger(uint8_t events, uint16_t postRecords)
+{
+  this->events = events;
+  this->postRecords = (postRecords >= ARTNET_CAPTURE_RECORDS) ? ARTNET_CAPTURE_RECORDS - 1 : postRecords;
+}
+
+// **** Function ArtnetCapture::arm() ****
+// Descr: Empties the ring and starts recording again, also after the trigger froze it.
+void ArtnetCapture::arm()
+{
+  head = 0;
+  count = 0;
+  fired = false;
+  frozen = false;
+  gaps = 0;
+  postRemaining = 0;
+  memset(sequences, 0, sizeof(sequences));
+}
+
+// **** Function ArtnetCapture::trigger() ****
+// Descr: Fires the trigger on the newest record, e.g. when the show glitched. Ignored when it already fired.
+void ArtnetCapture::trigger()
+{
+  if(fired)
+    return;
+
+  fired = true;
+  postRemaining = postRecords;
+  if(count)
+    at(count - 1)->flags |= ARTNET_CAPTURE_TRIGGER;
+  if(!postRemaining)
+    frozen = true;
+}
+
+// **** Function ArtnetCapture::record() ****
+// Descr: Adds a datagram to the ring. Called by Artnet::read() for every received datagram once the capture is attached.
+void ArtnetCapture::record(const uint8_t *packet, uint16_t size, IPAddress remoteIP)
+{
+  if(frozen)
+    return;
+
+  struct captureRecord_s *r = &records[head];
+  r->time = micros();
+  for(uint8_t i=0 ; i < 4 ; i++)
+    r->ip[i] = remoteIP[i];
+  r->length = size;
+  r->flags = 0;
+  memcpy(r->data, packet, (size < ARTNET_CAPTURE_SNAP) ? size : ARTNET_CAPTURE_SNAP);
+
+  if(++head == ARTNET_CAPTURE_RECORDS)
+    head = 0;
+  if(count < ARTNET_CAPTURE_RECORDS)
+    count++;
+
+  bool gap = checkSequence(packet, size);
+  if(gap)
+  {
+    r->flags |= ARTNET_CAPTURE_GAP;
+    gaps++;
+  }
+
+  if(fired)
+  {
+    if(--postRemaining == 0)
+      frozen = true;
+  }
+  else if(gap && (events & ARTNET_CAPTURE_ON_GAP))
+    trigger();
+}
+
+// **** Function ArtnetCapture::checkSequence() ****
+// Descr: Follows the ArtDmx sequence number per universe (1 to 255, 0 = sequencing disabled by the sender).
+// Return: true when the sequence number is not the one following the previous packet of that universe.
+bool ArtnetCapture::checkSequence(const uint8_t *packet, uint16_t size)
+{
+  if(size < ART_DMX_START || memcmp(packet, ART_NET_ID, 8) != 0 || (packet[8] | packet[9] << 8) != ART_DMX)
+    return false;
+
+  uint8_t seq = packet[12];
+  uint16_t universe = packet[14] | packet[15] << 8;
+  if(!seq)
+    return false;
+
+  struct captureSequence_s *s = &sequences[universe & (ARTNET_CAPTURE_UNIVERSES - 1)];
+  if(s->universe != universe || !s->sequence)
+  {
+    s->universe = universe;
+    s->sequence = seq;
+    return false;
+  }
+
+  uint8_t expected = (s->sequence == 255) ? 1 : s->sequence + 1;
+  s->sequence = seq;
+  return seq != expected;
+}
+
+// **** Function ArtnetCapture::at() ****
+// Descr: Returns the i-th record, 0 being the oldest one in the ring.
+struct captureRecord_s* ArtnetCapture::at(uint16_t i)
+{
+  uint16_t index = head + ARTNET_CAPTURE_RECORDS - count + i;
+  if(index >= ARTNET_CAPTURE_RECORDS)
+    index -= ARTNET_CAPTURE_RECORDS;
+  return &records[index];
+}
+
+// **** Function ArtnetCapture::dump() ****
+// Descr: Prints the ring, oldest first, one line per datagram: arrival time and delta in us, sender, length, opcode,
+//        for ArtDmx the universe, sequence and data length, and GAP/TRIGGER marks. out can be Serial or an SD file.
+// Argumenets: payload = also print the captured bytes after the Art-Net header in hex.
+// Return: the number of records printed.
+uint16_t ArtnetCapture::dump(Print &out, bool payload)
+{
+  char line[112];
+  uint32_t previous = count ? at(0)->time : 0;
+
+  for(uint16_t i=0 ; i < count ; i++)
+  {
+    struct captureRecord_s *r = at(i);
+    uint16_t captured = (r->length < ARTNET_CAPTURE_SNAP) ? r->length : ARTNET_CAPTURE_SNAP;
+    uint16_t headerSize = 0;
+
+    int n = snprintf(line, sizeof(line), "%10lu %+9ld %u.%u.%u.%u %4u", (unsigned long)r->time, (long)(r->time - previous),
+                     r->ip[0], r->ip[1], r->ip[2], r->ip[3], r->length);
+    previous = r->time;
+
+    if(captured >= 10 && memcmp(r->data, ART_NET_ID, 8) == 0)
+    {
+      uint16_t op = r->data[8] | r->data[9] << 8;
+      n += snprintf(line + n, sizeof(line) - n, " op=0x%04X", op);
+      if(op == ART_DMX && captured >= ART_DMX_START)
+      {
+        n += snprintf(line + n, sizeof(line) - n, " u=%u s=%u n=%u", r->data[14] | r->data[15] << 8, r->data[12], r->data[17] | r->data[16] << 8);
+        headerSize = ART_DMX_START;
+      }
+    }
+    else
+      n += snprintf(line + n, sizeof(line) - n, " not Art-Net");
+
+    snprintf(line + n, sizeof(line) - n, "%s%s\n", (r->flags & ARTNET_CAPTURE_GAP) ? " GAP" : "",
+             (r->flags & ARTNET_CAPTURE_TRIGGER) ? " TRIGGER" : "");
+    out.print(line);
+
+    if(payload)
+    {
+      for(uint16_t j=headerSize ; j < captured ; j += 32)
+      {
+        n = snprintf(line, sizeof(line), "          ");
+        for(uint16_t k=j ; k < captured && k < j + 32 ; k++)
+          n += snprintf(line + n, sizeof(line) - n, " %02X", r->data[k]);
+        snprintf(line + n, sizeof(line) - n, "\n");
+        out.print(line);
+      }
+    }
+  }
+  return count;
+}
+
+// **** Function ArtnetCapture::dumpPcap() ****
+// Descr: Writes the ring as a pcap file (IPv4 link type) that Wireshark decodes as Art-Net. The IPv4 and UDP headers
+//        are made up from the record: sender to localIP, port 6454 to 6454. Datagrams are truncated to the captured bytes.
+//        On boards the timestamps are the micros() at arrival, on the host they are converted to wall clock time.
+// Return: the number of records written.
+uint16_t ArtnetCapture::dumpPcap(Print &out, IPAddress localIP)
+{
+  uint8_t header[24];
+  capturePutLe32(&header[0], 0xA1B2C3D4);           //Magic, microsecond timestamps
+  header[4] = 2; header[5] = 0;                      //Version 2.4
+  header[6] = 4; header[7] = 0;
+  capturePutLe32(&header[8], 0);                     //Timezone
+  capturePutLe32(&header[12], 0);                    //Timestamp accuracy
+  capturePutLe32(&header[16], 0xFFFF);               //Snapshot length
+  capturePutLe32(&header[20], ARTNET_PCAP_LINKTYPE_IPV4);
+  out.write(header, sizeof(header));
+
+  #if defined(ARTNET_HOST)
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t wallNow = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    uint32_t now = micros();
+  #endif
+
+  for(uint16_t i=0 ; i < count ; i++)
+  {
+    struct captureRecord_s *r = at(i);
+    uint16_t captured = (r->length < ARTNET_CAPTURE_SNAP) ? r->length : ARTNET_CAPTURE_SNAP;
+
+    #if defined(ARTNET_HOST)
+      uint64_t t = wallNow - (uint32_t)(now - r->time);
+    #else
+      uint32_t t = r->time;
+    #endif
+
+    uint8_t h[16 + ARTNET_PCAP_HEADERS];
+    capturePutLe32(&h[0], t / 1000000);
+    capturePutLe32(&h[4], t % 1000000);
+    capturePutLe32(&h[8], ARTNET_PCAP_HEADERS + captured);
+    capturePutLe32(&h[12], ARTNET_PCAP_HEADERS + r->length);
+
+    //IPv4 header
+    uint8_t *ip = &h[16];
+    memset(ip, 0, 20);
+    ip[0] = 0x45;
+    capturePutBe16(&ip[2], 20 + 8 + r->length);
+    ip[6] = 0x40;                                    //Don't fragment
+    ip[8] = 64;                                      //TTL
+    ip[9] = 17;                                      //UDP
+    memcpy(&ip[12], r->ip, 4);
+    for(uint8_t j=0 ; j < 4 ; j++)
+      ip[16 + j] = localIP[j];
+    uint32_t sum = 0;
+    for(uint8_t j=0 ; j < 20 ; j += 2)
+      sum += ip[j] << 8 | ip[j + 1];
+    while(sum >> 16)
+      sum = (sum & 0xFFFF) + (sum >> 16);
+    capturePutBe16(&ip[10], ~sum);
+
+    //UDP header, checksum 0 = not computed
+    uint8_t *udp = &h[36];
+    capturePutBe16(&udp[0], ART_NET_PORT);
+    capturePutBe16(&udp[2], ART_NET_PORT);
+    capturePutBe16(&udp[4], 8 + r->length);
+    capturePutBe16(&udp[6], 0);
+
+    out.write(h, sizeof(h));
+    out.write(r->data, captured);
+  }
+  return count;
+}
+
+#if defined(ARTNET_HOST)
+// Print on a stdio file, for dumpPcap(path).
+class CaptureFile : public Print
+{
+  public:
+    CaptureFile(FILE *f) : file(f) {}
+    using  Print::write;
+    size_t write(const uint8_t *buffer, size_t size) { return fwrite(buffer, 1, size, file); }
+
+  private:
+    FILE *file;
+};
+
+// **** Function ArtnetCapture::dumpPcap(path) ****
+// Descr: Writes the ring as pcap file to path, see dumpPcap(out).
+// Return: the number of records written, 0 when the file could not be written.
+uint16_t ArtnetCapture::dumpPcap(const char *path, IPAddress localIP)
+{
+  FILE *f = fopen(path, "wb");
+  if(!f)
+    return 0;
+
+  CaptureFile file(f);
+  uint16_t n = dumpPcap(file, localIP);
+  return (fclose(f) == 0) ? n : 0;
+}
+#endif
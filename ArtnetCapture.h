@@ -0,0 +1,132 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Black-box capture of the received datagrams.
+// Attach it with Artnet::setCapture() and the last ARTNET_CAPTURE_RECORDS datagrams are kept in a preallocated ring:
+// arrival time, sender, length and the first ARTNET_CAPTURE_SNAP bytes (the Art-Net header and optionally some payload).
+// Recording is a single bounded copy per packet, so unlike DEBUG output it does not change the timing of the node.
+// A trigger (ArtDmx sequence gap or a call to trigger()) freezes the ring after a number of further records, the
+// frozen ring can then be dumped as text or as a pcap file for Wireshark.
+
+#ifndef ARTNET_CAPTURE_H
+#define ARTNET_CAPTURE_H
+
+// Included from Artnet.h
+
+#ifndef ARTNET_CAPTURE_RECORDS
+  #if defined(ARTNET_HOST)
+    #define ARTNET_CAPTURE_RECORDS  1024        // Datagrams kept in the ring.
+  #else
+    #define ARTNET_CAPTURE_RECORDS  32
+  #endif
+#endif
+#ifndef ARTNET_CAPTURE_SNAP
+  #if defined(ARTNET_HOST)
+    #define ARTNET_CAPTURE_SNAP     MAX_BUFFER_ARTNET   // Bytes kept of every datagram, at least ART_DMX_START.
+  #else
+    #define ARTNET_CAPTURE_SNAP     24
+  #endif
+#endif
+#ifndef ARTNET_CAPTURE_UNIVERSES
+  #if defined(ARTNET_HOST)
+    #define ARTNET_CAPTURE_UNIVERSES 256        // Universes tracked for sequence gaps, must be a power of 2.
+  #else
+    #define ARTNET_CAPTURE_UNIVERSES 16
+  #endif
+#endif
+
+// Trigger events, see setTrigger().
+#define   ARTNET_CAPTURE_ON_GAP     0x01        // An ArtDmx sequence number was skipped or arrived out of order.
+
+// Record flags
+#define   ARTNET_CAPTURE_GAP        0x01        // This ArtDmx broke the sequence of its universe.
+#define   ARTNET_CAPTURE_TRIGGER    0x02        // The trigger fired on this record.
+
+struct captureRecord_s {
+  uint32_t    time;                           //micros() at arrival.
+  uint8_t     ip[4];                          //Sender.
+  uint16_t    length;                         //Length of the datagram, only the first ARTNET_CAPTURE_SNAP bytes are kept.
+  uint8_t     flags;
+  uint8_t     data[ARTNET_CAPTURE_SNAP];
+};
+
+class ArtnetCapture
+{
+  public:
+    ArtnetCapture();
+
+    void     setTrigger(uint8_t events, uint16_t postRecords);
+    void     record(const uint8_t *packet, uint16_t size, IPAddress remoteIP);
+    void     trigger(void);
+    void     arm(void);
+    uint16_t dump(Print &out, bool payload = false);
+    uint16_t dumpPcap(Print &out, IPAddress localIP = IPAddress());
+  #if defined(ARTNET_HOST)
+    uint16_t dumpPcap(const char *path, IPAddress localIP = IPAddress());
+  #endif
+
+    // **** Function ArtnetCapture::triggered() ****
+    // Descr: True once the trigger fired and the post trigger records are in, the ring is then frozen until arm().
+    inline bool triggered(void)
+    {
+      return frozen;
+    }
+
+    // **** Function ArtnetCapture::getCount() ****
+    // Descr: Returns the number of records in the ring.
+    inline uint16_t getCount(void)
+    {
+      return count;
+    }
+
+    // **** Function ArtnetCapture::getGaps() ****
+    // Descr: Returns the number of ArtDmx sequence gaps seen since the last arm().
+    inline uint32_t getGaps(void)
+    {
+      return gaps;
+    }
+
+  private:
+    struct captureRecord_s records[ARTNET_CAPTURE_RECORDS];
+    uint16_t  head;                           //Next record to write.
+    uint16_t  count;
+    uint8_t   events;                         //Enabled trigger events.
+    uint16_t  postRecords;                    //Records kept after the trigger.
+    uint16_t  postRemaining;
+    bool      fired;
+    bool      frozen;
+    uint32_t  gaps;
+
+    struct captureSequence_s {
+      uint16_t  universe;
+      uint8_t   sequence;                     //Last sequence number, 0 = not seen yet (or sequencing disabled).
+    } sequences[ARTNET_CAPTURE_UNIVERSES];
+
+    bool     checkSequence(const uint8_t *packet, uint16_t size);
+    struct captureRecord_s* at(uint16_t i);
+};
+
+#endif
@@ -0,0 +1,264 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+#if defined(ARTNET_HOST)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+ArtnetCue::ArtnetCue() : show(NULL), reader(NULL), size(0), universes(0), entries(0), frameSize(0), indexStart(0),
+                         current(-1), time(0), lastChange(0), running(false)
+{
+  #if defined(ARTNET_HOST)
+    mapped = 0;
+  #endif
+}
+
+// **** Function ArtnetCue::begin(show, size) ****
+// Descr: Plays a show held in memory, e.g. a const array in flash. The show is used in place.
+// Return: 1 = success ; 0 = not a valid show.
+uint8_t ArtnetCue::begin(const uint8_t *show, uint32_t size)
+{
+  end();
+  this->show = show;
+  this->size = size;
+  return load();
+}
+
+// **** Function ArtnetCue::begin(reader, size) ****
+// Descr: Plays a show that is read through reader, e.g. from an SD file. reader copies size bytes from offset into
+//        buffer and returns 1, or 0 when that failed.
+// Return: 1 = success ; 0 = not a valid show.
+uint8_t ArtnetCue::begin(uint8_t (*reader)(uint32_t offset, uint8_t *buffer, uint16_t size), uint32_t size)
+{
+  end();
+  this->reader = reader;
+  this->size = size;
+  return load();
+}
+
+#if defined(ARTNET_HOST)
+// **** Function ArtnetCue::begin(path) ****
+// Descr: Plays a show file, it is memory mapped so only the frames that are shown are paged in.
+// Return: 1 = success ; 0 = the file could not be mapped or is not a valid show.
+uint8_t ArtnetCue::begin(const char *path)
+{
+  end();
+
+  int fd = open(path, O_RDONLY);
+  if(fd < 0)
+    return 0;
+
+  struct stat st;
+  void *p = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && st.st_size > 0)
+    p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED)
+    return 0;
+
+  show = (const uint8_t*)p;
+  size = st.st_size;
+  mapped = st.st_size;
+  return load();
+}
+#endif
+
+// **** Function ArtnetCue::end() ****
+// Descr: Stops playing the show.
+void ArtnetCue::end()
+{
+  #if defined(ARTNET_HOST)
+    if(mapped)
+      munmap((void*)show, mapped);
+    mapped = 0;
+  #endif
+  show = NULL;
+  reader = NULL;
+  size = 0;
+  universes = 0;
+  entries = 0;
+  current = -1;
+  running = false;
+}
+
+// **** Function ArtnetCue::load() ****
+// Descr: Checks the show header and that the universe list and index fit in the show.
+// Return: 1 = valid show ; 0 = invalid, the show is closed.
+uint8_t ArtnetCue::load()
+{
+  if(size < ARTNET_CUE_HEADER || readLong(0) != ARTNET_CUE_MAGIC || (readWord(4) & 0xFF) != ARTNET_CUE_VERSION)
+  {
+    end();
+    return 0;
+  }
+
+  universes = readWord(6);
+  entries = readLong(8);
+  frameSize = readWord(12);
+  indexStart = ARTNET_CUE_HEADER + 2 * (uint32_t)universes;
+
+  if(frameSize > ARTNET_DMX_CHANNELS || entries > (size - indexStart) / ARTNET_CUE_ENTRY || indexStart > size)
+  {
+    end();
+    return 0;
+  }
+  current = -1;
+  return 1;
+}
+
+uint16_t ArtnetCue::readWord(uint32_t offset)
+{
+  uint8_t b[2] = {0, 0};
+  if(show)
+    memcpy(b, show + offset, 2);
+  else if(reader)
+    reader(offset, b, 2);
+  return b[0] | b[1] << 8;
+}
+
+uint32_t ArtnetCue::readLong(uint32_t offset)
+{
+  uint8_t b[4] = {0, 0, 0, 0};
+  if(show)
+    memcpy(b, show + offset, 4);
+  else if(reader)
+    reader(offset, b, 4);
+  return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+}
+
+uint32_t ArtnetCue::entryTime(uint32_t i)
+{
+  return readLong(indexStart + i * ARTNET_CUE_ENTRY);
+}
+
+// **** Function ArtnetCue::timecodeToMillis() ****
+// Descr: Converts a timecode to ms since 00:00:00:00. Drop frame timecode skips frame labels 0 and 1 at the start of
+//        every minute except every tenth, so it is converted to real time at 29.97 fps.
+// Return: time in ms, -1 for an invalid timecode.
+int32_t ArtnetCue::timecodeToMillis(const struct timecode_s *tc)
+{
+  const uint8_t fps[4] = {24, 25, 30, 30};
+  if(tc->type > ART_TC_SMPTE || tc->hours > 23 || tc->minutes > 59 || tc->seconds > 59 || tc->frames >= fps[tc->type])
+    return -1;
+
+  uint32_t minutes = tc->hours * 60 + tc->minutes;
+  uint32_t frames = (minutes * 60 + tc->seconds) * fps[tc->type] + tc->frames;
+  if(tc->type == ART_TC_DF)
+  {
+    frames -= 2 * (minutes - minutes / 10);
+    return (int32_t)(((uint64_t)frames * 1001) / 30);
+  }
+  return (int32_t)(((uint64_t)frames * 1000) / fps[tc->type]);
+}
+
+// **** Function ArtnetCue::locate() ****
+// Descr: Finds the entry shown at time, the last entry with a time at or before it. While the timecode runs this is
+//        the current or the next entry, otherwise (a jump) the index is binary searched.
+// Return: the entry, -1 when time is before the first entry.
+int32_t ArtnetCue::locate(uint32_t time)
+{
+  if(!entries)
+    return -1;
+
+  //Playing on: still the current entry, or the next one.
+  if(current >= 0 && entryTime(current) <= time)
+  {
+    uint32_t next = current + 1;
+    if(next == entries || entryTime(next) > time)
+      return current;
+    if(next + 1 == entries || entryTime(next + 1) > time)
+      return next;
+  }
+
+  //Jump: the first entry after time, minus one.
+  uint32_t low = 0, high = entries;
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    if(entryTime(mid) <= time)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return (int32_t)low - 1;
+}
+
+// **** Function ArtnetCue::chase() ****
+// Descr: Follows a received timecode. Called by Artnet::read() for every ArtTimeCode once the cue is attached.
+// Return: 1 = an other entry (or a blackout before the first entry) must be shown, its universes are read with
+//         getData() ; 0 = nothing changed.
+uint8_t ArtnetCue::chase(const struct timecode_s *tc)
+{
+  int32_t t = timecodeToMillis(tc);
+  if(t < 0 || !entries)
+    return 0;
+
+  if((uint32_t)t != time || !running)
+    lastChange = millis();
+  time = t;
+  running = true;
+
+  int32_t entry = locate(time);
+  if(entry == current)
+    return 0;
+
+  //Entries sharing a frame do not need to be output again.
+  bool changed = (entry < 0 || current < 0 || readLong(indexStart + entry * ARTNET_CUE_ENTRY + 4) != readLong(indexStart + current * ARTNET_CUE_ENTRY + 4));
+  current = entry;
+  return changed ? 1 : 0;
+}
+
+// **** Function ArtnetCue::getData() ****
+// Descr: Returns the DMX data of the i-th universe of the entry that is shown (getLength() channels), all zero before
+//        the first entry. With a reader the data is read into a buffer that is reused by the next call.
+// Return: pointer to the data, NULL without show or when the frame lies outside the show.
+const uint8_t* ArtnetCue::getData(uint16_t i)
+{
+  if(!entries || i >= universes)
+    return NULL;
+
+  //Before the first entry nothing of the show is on, the last frame that was output must not stay on the fixtures.
+  if(current < 0)
+  {
+    memset(buffer, 0, frameSize);
+    return buffer;
+  }
+
+  uint32_t offset = readLong(indexStart + current * ARTNET_CUE_ENTRY + 4) + (uint32_t)i * frameSize;
+  if(offset > size || frameSize > size - offset)
+    return NULL;
+
+  if(show)
+    return show + offset;
+  if(!reader(offset, buffer, frameSize))
+    return NULL;
+  return buffer;
+}
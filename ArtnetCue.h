@@ -0,0 +1,142 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Timecode chased cue playback.
+// A show holds precomputed frames of a set of universes, indexed by time. Attached with Artnet::setCue(), every
+// ArtTimeCode looks up the frame for that time and, when it differs from the one shown, hands its universes to the
+// same outputs as received ArtDmx (callback, patch, watch, gateway, ...) followed by an ArtSync. The node follows the
+// console's clock (jumps, pauses, all four frame rate types) without a single ArtDmx on the network.
+//
+// Show layout, all numbers little endian:
+//     header      16 bytes: magic "ANSH", version, reserved, universe count (16 bit), entry count (32 bit),
+//                 bytes per universe (16 bit), reserved (16 bit)
+//     universes   Port-Address of each universe (16 bit each)
+//     index       entries sorted on time: time in ms from 00:00:00:00 (32 bit), offset of the frame data (32 bit)
+//     data        frames of (universe count x bytes per universe) bytes, entries may share a frame
+// A frame is held until the time of the next entry, so static parts of a show need a single entry. A jump to before
+// the first entry blacks out the universes of the show.
+// The show is read from memory (a const array in memory mapped flash such as on Teensy and ESP32, or a memory mapped
+// file on Linux) or through a read function (e.g. an SD file). Locating a frame is O(1) while the timecode runs and a binary search after a jump.
+
+#ifndef ARTNET_CUE_H
+#define ARTNET_CUE_H
+
+// Included from Artnet.h
+
+#define   ARTNET_CUE_MAGIC          0x48534E41  // "ANSH"
+#define   ARTNET_CUE_VERSION        1
+#define   ARTNET_CUE_HEADER         16          // Size of the show header.
+#define   ARTNET_CUE_ENTRY          8           // Size of an index entry.
+#define   ARTNET_CUE_PAUSE          250         // ms without a new timecode before the timecode is considered paused.
+
+// *** ArtTimeCode types
+#define   ART_TC_FILM               0           // 24 fps
+#define   ART_TC_EBU                1           // 25 fps
+#define   ART_TC_DF                 2           // 29.97 fps drop frame
+#define   ART_TC_SMPTE              3           // 30 fps
+
+class ArtnetCue
+{
+  public:
+    ArtnetCue();
+
+    uint8_t  begin(const uint8_t *show, uint32_t size);
+    uint8_t  begin(uint8_t (*reader)(uint32_t offset, uint8_t *buffer, uint16_t size), uint32_t size);
+  #if defined(ARTNET_HOST)
+    uint8_t  begin(const char *path);
+  #endif
+    void     end(void);
+    uint8_t  chase(const struct timecode_s *tc);
+    int32_t  locate(uint32_t time);
+    const uint8_t* getData(uint16_t i);
+    static int32_t timecodeToMillis(const struct timecode_s *tc);
+
+    // **** Function ArtnetCue::getUniverses() ****
+    // Descr: Returns the number of universes in each frame of the show.
+    inline uint16_t getUniverses(void)
+    {
+      return universes;
+    }
+
+    // **** Function ArtnetCue::getUniverse() ****
+    // Descr: Returns the Port-Address of the i-th universe of the show.
+    inline uint16_t getUniverse(uint16_t i)
+    {
+      return readWord(ARTNET_CUE_HEADER + 2 * i);
+    }
+
+    // **** Function ArtnetCue::getLength() ****
+    // Descr: Returns the number of DMX channels stored for every universe.
+    inline uint16_t getLength(void)
+    {
+      return frameSize;
+    }
+
+    // **** Function ArtnetCue::getEntry() ****
+    // Descr: Returns the index entry that is shown, -1 before the first entry or without show.
+    inline int32_t getEntry(void)
+    {
+      return current;
+    }
+
+    // **** Function ArtnetCue::getTime() ****
+    // Descr: Returns the time in ms of the last chased timecode.
+    inline uint32_t getTime(void)
+    {
+      return time;
+    }
+
+    // **** Function ArtnetCue::isRunning() ****
+    // Descr: True while the timecode is moving, false once it stopped or paused for ARTNET_CUE_PAUSE ms.
+    inline bool isRunning(void)
+    {
+      return running && (millis() - lastChange) < ARTNET_CUE_PAUSE;
+    }
+
+  private:
+    const uint8_t *show;                      //Show in memory, NULL when it is read through reader.
+    uint8_t (*reader)(uint32_t offset, uint8_t *buffer, uint16_t size);
+    uint32_t  size;
+    uint16_t  universes;
+    uint32_t  entries;
+    uint16_t  frameSize;
+    uint32_t  indexStart;
+    int32_t   current;                        //Entry that is shown.
+    uint32_t  time;
+    uint32_t  lastChange;
+    bool      running;
+    uint8_t   buffer[ARTNET_DMX_CHANNELS];    //One universe, when the show is read through reader.
+  #if defined(ARTNET_HOST)
+    size_t    mapped;                         //Size of the mapping made by begin(path).
+  #endif
+
+    uint8_t  load(void);
+    uint16_t readWord(uint32_t offset);
+    uint32_t readLong(uint32_t offset);
+    uint32_t entryTime(uint32_t i);
+};
+
+#endif
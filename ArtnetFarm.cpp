@@ -0,0 +1,211 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <ArtnetFarm.h>
+
+#if defined(ARTNET_HOST)
+
+ArtnetFarm::ArtnetFarm() : nodes(NULL), stats(NULL), maxNodes(0), numNodes(0), reportTime(0), unrouted(0), routeHead(NULL), routeNext(NULL) {}
+
+ArtnetFarm::~ArtnetFarm()
+{
+  delete[] nodes;
+  delete[] stats;
+  delete[] routeHead;
+  delete[] routeNext;
+}
+
+// **** Function ArtnetFarm::begin() ****
+// Descr: Allocates room for maxNodes nodes and opens the shared Art-Net socket.
+// Argumenets: maxNodes = the maximum number of virtual nodes, bindIP = the address to listen on (default all interfaces).
+// Return: 1 = success ; 0 = the socket could not be opened.
+uint8_t ArtnetFarm::begin(uint16_t maxNodes, IPAddress bindIP)
+{
+  this->maxNodes = maxNodes;
+  nodes     = new Artnet[maxNodes];
+  stats     = new farmStats_s[maxNodes];
+  routeHead = new uint16_t[ARTNET_PORT_ADDRESSES];
+  routeNext = new uint16_t[maxNodes * ART_NUM_UNIVERSES];
+  memset(stats, 0, maxNodes * sizeof(farmStats_s));
+  buildRoutes();
+  reportTime = millis();
+
+  return Udp.begin(bindIP, ART_NET_PORT);
+}
+
+// **** Function ArtnetFarm::addNode() ****
+// Descr: Adds a virtual node with IP address ip[], its ports get consecutive Port-Addresses starting at firstPortAddress.
+//        The MAC address is derived from the IP address and marked as locally administered.
+// Return: index of the node, -1 when the farm is full.
+int16_t ArtnetFarm::addNode(byte ip[], uint16_t firstPortAddress)
+{
+  if(numNodes >= maxNodes)
+    return -1;
+
+  uint16_t index = numNodes++;
+  byte mac[6] = {0x02, 0x00, ip[0], ip[1], ip[2], ip[3]};
+  char name[18];
+
+  nodes[index].beginShared(mac, ip, Udp);
+  snprintf(name, sizeof(name), "Farm node %u", index);
+  nodes[index].setShortDescr(name);
+  for(uint8_t port=0 ; port < ART_NUM_UNIVERSES ; port++)
+    nodes[index].setPortAddress(port, firstPortAddress + port);
+
+  buildRoutes();
+  return index;
+}
+
+// **** Function ArtnetFarm::read() ****
+// Descr: Receives one packet from the shared socket and hands it to the nodes it is meant for.
+// Return: the opcode of the packet, 0 when nothing was received or the packet is not Art-Net.
+uint16_t ArtnetFarm::read()
+{
+  int size = Udp.parsePacket();
+  if(size <= 0 || size > MAX_BUFFER_ARTNET)
+    return 0;
+  uint32_t received = micros();                 //Latencies are measured from here, for every node the packet goes to.
+
+  IPAddress remoteIP = Udp.remoteIP();
+  IPAddress destIP = Udp.destinationIP();
+  Udp.read(packet, MAX_BUFFER_ARTNET);
+
+  if(memcmp(packet, ART_NET_ID, 8) != 0)
+    return 0;
+  uint16_t opcode = packet[8] | packet[9] << 8;
+
+  if(opcode == ART_DMX)
+  {
+    if(size < ART_DMX_START)
+      return 0;
+
+    uint16_t portAddress = (packet[14] | packet[15] << 8) & 0x7FFF;
+    uint16_t dataLength = packet[17] | packet[16] << 8;
+    if(dataLength > size - ART_DMX_START)     //Only count the data that was received, the nodes clamp the same way.
+      dataLength = size - ART_DMX_START;
+    uint16_t last = ARTNET_FARM_NONE;
+    if(routeHead[portAddress] == ARTNET_FARM_NONE)
+      unrouted++;
+
+    for(uint16_t p = routeHead[portAddress] ; p != ARTNET_FARM_NONE ; p = routeNext[p])
+    {
+      uint16_t index = p / ART_NUM_UNIVERSES;
+      if(index == last)           //Node listens to this universe on more than one port.
+        continue;
+      last = index;
+      stats[index].dmxPackets++;
+      stats[index].dmxBytes += dataLength;
+      deliver(index, size, remoteIP, received);
+    }
+    return opcode;
+  }
+
+  //Unicast goes to the node owning the destination address, everything else to all nodes.
+  bool unicast = false;
+  for(uint16_t index=0 ; index < numNodes && !unicast ; index++)
+    unicast = (destIP == nodes[index].getNodeIP());
+
+  bool changed = false;
+  for(uint16_t index=0 ; index < numNodes ; index++)
+  {
+    if(unicast && destIP != nodes[index].getNodeIP())
+      continue;
+
+    deliver(index, size, remoteIP, received);
+    if(opcode == ART_ADDRESS)
+      changed = true;
+  }
+
+  //ArtAddress may have moved Port-Addresses around.
+  if(changed)
+    buildRoutes();
+  return opcode;
+}
+
+// **** Function ArtnetFarm::deliver() ****
+// Descr: Passes the packet to one node and measures the time from the reception of the packet (received) until the
+//        node answered an ArtPoll, so nodes served later include the time spent on the nodes before them.
+uint16_t ArtnetFarm::deliver(uint16_t index, uint16_t size, IPAddress remoteIP, uint32_t received)
+{
+  uint16_t result = nodes[index].read(packet, size, remoteIP);
+
+  if(nodes[index].getOpcode() == ART_POLL)
+  {
+    uint32_t latency = micros() - received;
+    stats[index].polls++;
+    stats[index].pollLatencySum += latency;
+    if(latency > stats[index].pollLatencyMax)
+      stats[index].pollLatencyMax = latency;
+  }
+  return result;
+}
+
+// **** Function ArtnetFarm::buildRoutes() ****
+// Descr: Rebuilds the Port-Address to node table. Ports are chained in node order so duplicates of one node are adjacent.
+void ArtnetFarm::buildRoutes()
+{
+  for(uint32_t a=0 ; a < ARTNET_PORT_ADDRESSES ; a++)
+    routeHead[a] = ARTNET_FARM_NONE;
+
+  for(int32_t p = numNodes * ART_NUM_UNIVERSES - 1 ; p >= 0 ; p--)
+  {
+    uint16_t portAddress = nodes[p / ART_NUM_UNIVERSES].getPortAddress(p % ART_NUM_UNIVERSES) & 0x7FFF;
+    routeNext[p] = routeHead[portAddress];
+    routeHead[portAddress] = p;
+  }
+}
+
+// **** Function ArtnetFarm::printReport() ****
+// Descr: Prints the receive rate and poll reply latency of every node since the previous report, then clears the counters.
+void ArtnetFarm::printReport()
+{
+  uint32_t now = millis();
+  float seconds = (now - reportTime) / 1000.0f;
+  if(seconds <= 0)
+    seconds = 1;
+
+  uint32_t totalPackets = 0;
+  printf("node  ip               universe  dmx/s     kB/s      polls  reply avg/max [us]\n");
+  for(uint16_t index=0 ; index < numNodes ; index++)
+  {
+    struct farmStats_s *s = &stats[index];
+    IPAddress ip = nodes[index].getNodeIP();
+    char ipText[16];
+    snprintf(ipText, sizeof(ipText), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+
+    printf("%-5u %-16s %-9u %-9.1f %-9.1f %-6u %u/%u\n", index, ipText, nodes[index].getPortAddress(0),
+           s->dmxPackets / seconds, s->dmxBytes / seconds / 1000.0f, s->polls,
+           s->polls ? s->pollLatencySum / s->polls : 0, s->pollLatencyMax);
+    totalPackets += s->dmxPackets;
+  }
+  printf("total %.1f dmx/s over %u nodes, %u packets for unpatched universes\n", totalPackets / seconds, numNodes, unrouted);
+
+  memset(stats, 0, numNodes * sizeof(farmStats_s));
+  unrouted = 0;
+  reportTime = now;
+}
+
+#endif
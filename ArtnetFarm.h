@@ -0,0 +1,103 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Virtual node farm (Linux host only)
+// Runs many Artnet nodes in one process on a single socket, for load testing controllers, switches and gateways.
+// Every node has its own node_s, Port-Addresses and IP address (loopback 127.x.y.z or alias IPs on an interface).
+// ArtDmx is demultiplexed on Port-Address, other opcodes go to the node they are unicast to or to all on broadcast.
+
+#ifndef ARTNET_FARM_H
+#define ARTNET_FARM_H
+
+#include <Artnet.h>
+
+#if defined(ARTNET_HOST)
+
+#define ARTNET_PORT_ADDRESSES     0x8000      // 15 bit Port-Address space.
+#define ARTNET_FARM_NONE          0xFFFF      // End of a route chain.
+
+struct farmStats_s {
+  uint32_t    dmxPackets;                     //ArtDmx packets routed to the node.
+  uint32_t    dmxBytes;                       //DMX payload bytes routed to the node.
+  uint32_t    polls;                          //ArtPoll packets answered.
+  uint32_t    pollLatencySum;                 //us, from receive until the last OpPollReply was sent.
+  uint32_t    pollLatencyMax;                 //us
+};
+
+class ArtnetFarm
+{
+  public:
+    ArtnetFarm();
+    ~ArtnetFarm();
+
+    uint8_t  begin(uint16_t maxNodes, IPAddress bindIP = IPAddress());
+    int16_t  addNode(byte ip[], uint16_t firstPortAddress);
+    uint16_t read(void);
+    void     printReport(void);
+
+    // **** Function ArtnetFarm::getNode() ****
+    // Descr: Gives access to a node, e.g. to set callbacks or names.
+    inline Artnet* getNode(uint16_t index)
+    {
+      return (index < numNodes) ? &nodes[index] : NULL;
+    }
+
+    // **** Function ArtnetFarm::getNumNodes() ****
+    // Descr: Returns the number of nodes added to the farm.
+    inline uint16_t getNumNodes(void)
+    {
+      return numNodes;
+    }
+
+    // **** Function ArtnetFarm::getStats() ****
+    // Descr: Returns the counters of a node since the last printReport().
+    inline struct farmStats_s* getStats(uint16_t index)
+    {
+      return (index < numNodes) ? &stats[index] : NULL;
+    }
+
+  private:
+    HostUDP   Udp;
+    Artnet   *nodes;
+    struct farmStats_s *stats;
+    uint16_t  maxNodes;
+    uint16_t  numNodes;
+    uint32_t  reportTime;
+    uint32_t  unrouted;                       //ArtDmx packets for a Port-Address no node listens to.
+    uint8_t   packet[MAX_BUFFER_ARTNET];
+
+    // Route table: routeHead[Port-Address] is the first node port listening to it, routeNext[] chains the others.
+    // A node port is numbered node * ART_NUM_UNIVERSES + port.
+    uint16_t *routeHead;
+    uint16_t *routeNext;
+
+    void     buildRoutes(void);
+    uint16_t deliver(uint16_t index, uint16_t size, IPAddress remoteIP, uint32_t received);
+};
+
+#endif
+
+#endif
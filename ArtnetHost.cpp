@@ -0,0 +1,355 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+#if defined(ARTNET_HOST)
+
+#include <errno.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+HostSerial Serial;
+HostEthernetClass Ethernet;
+
+static uint64_t monotonicMicros()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t millis()
+{
+  return (uint32_t)(monotonicMicros() / 1000);
+}
+
+uint32_t micros()
+{
+  return (uint32_t)monotonicMicros();
+}
+
+void delay(uint32_t ms)
+{
+  usleep(ms * 1000);
+}
+
+HostUDP::HostUDP() : sock(-1), owner(false), rxSize(0), rxOffset(0), rxRemotePort(0), txSize(0), txPort(0) {}
+
+HostUDP::~HostUDP()
+{
+  stop();
+}
+
+// **** Function HostUDP::begin(port) ****
+// Descr: Opens a socket listening on all interfaces.
+// Return: 1 = success ; 0 = the socket could not be opened or bound.
+uint8_t HostUDP::begin(uint16_t port)
+{
+  return begin(IPAddress(), port);
+}
+
+// **** Function HostUDP::begin(ip, port) ****
+// Descr: Opens a socket bound to ip (0.0.0.0 for all interfaces). Broadcast is enabled and the destination
+//        address of every received datagram is recorded, so shared sockets can tell unicast from broadcast.
+uint8_t HostUDP::begin(IPAddress ip, uint16_t port)
+{
+  stop();
+
+  sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if(sock < 0)
+    return 0;
+  owner = true;
+
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+  setsockopt(sock, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  if(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+  {
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+// **** Function HostUDP::share() ****
+// Descr: Uses the socket of udp for sending, with source as source address. The shared socket is not closed by this object.
+void HostUDP::share(const HostUDP &udp, IPAddress source)
+{
+  stop();
+  sock = udp.sock;
+  owner = false;
+  sourceIP = source;
+}
+
+void HostUDP::stop()
+{
+  if(owner && sock >= 0)
+    close(sock);
+  sock = -1;
+  owner = false;
+}
+
+// **** Function HostUDP::parsePacket() ****
+// Descr: Non blocking receive of the next datagram.
+// Return: size of the datagram, 0 when nothing is pending.
+int HostUDP::parsePacket()
+{
+  rxSize = 0;
+  rxOffset = 0;
+  if(sock < 0)
+    return 0;
+
+  struct sockaddr_in from;
+  struct iovec iov = { rxBuffer, sizeof(rxBuffer) };
+  uint8_t control[CMSG_SPACE(sizeof(struct in_pktinfo))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = &from;
+  msg.msg_namelen = sizeof(from);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t n = recvmsg(sock, &msg, MSG_DONTWAIT);
+  if(n <= 0)
+    return 0;
+
+  rxRemoteIP = IPAddress((uint32_t)from.sin_addr.s_addr);
+  rxRemotePort = ntohs(from.sin_port);
+  rxDestIP = IPAddress();
+  for(struct cmsghdr *c = CMSG_FIRSTHDR(&msg) ; c ; c = CMSG_NXTHDR(&msg, c))
+  {
+    if(c->cmsg_level == IPPROTO_IP && c->cmsg_type == IP_PKTINFO)
+      rxDestIP = IPAddress((uint32_t)((struct in_pktinfo*)CMSG_DATA(c))->ipi_addr.s_addr);
+  }
+
+  rxSize = (uint16_t)n;
+  return rxSize;
+}
+
+int HostUDP::read(uint8_t *buffer, size_t size)
+{
+  size_t n = rxSize - rxOffset;
+  if(n > size)
+    n = size;
+  memcpy(buffer, rxBuffer + rxOffset, n);
+  rxOffset += n;
+  return (int)n;
+}
+
+int HostUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  txIP = ip;
+  txPort = port;
+  txSize = 0;
+  return (sock >= 0) ? 1 : 0;
+}
+
+size_t HostUDP::write(const uint8_t *buffer, size_t size)
+{
+  if(size > sizeof(txBuffer) - txSize)
+    size = sizeof(txBuffer) - txSize;
+  memcpy(txBuffer + txSize, buffer, size);
+  txSize += size;
+  return size;
+}
+
+// **** Function HostUDP::endPacket() ****
+// Descr: Sends the datagram, from sourceIP when one was set through share().
+// Return: 1 = success, 0 = fail
+int HostUDP::endPacket()
+{
+  struct iovec iov = { txBuffer, txSize };
+  return sendVector(txIP, txPort, &iov, 1);
+}
+
+// **** Function HostUDP::sendGather() ****
+// Descr: Sends header and data as one datagram straight from both buffers, without the copy into txBuffer.
+// Return: 1 = success, 0 = fail
+int HostUDP::sendGather(IPAddress ip, uint16_t port, const uint8_t *header, size_t headerSize, const uint8_t *data, size_t dataSize)
+{
+  struct iovec iov[2] = { { (void*)header, headerSize }, { (void*)data, dataSize } };
+  return sendVector(ip, port, iov, dataSize ? 2 : 1);
+}
+
+// **** Function HostUDP::sendVector() ****
+// Descr: Sends the buffers of iov as one datagram, from sourceIP when one was set through share().
+// Return: 1 = success, 0 = fail
+int HostUDP::sendVector(IPAddress ip, uint16_t port, struct iovec *iov, int count)
+{
+  if(sock < 0)
+    return 0;
+
+  struct sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(port);
+  to.sin_addr.s_addr = (uint32_t)ip;
+
+  size_t size = 0;
+  for(int i=0 ; i < count ; i++)
+    size += iov[i].iov_len;
+
+  uint8_t control[CMSG_SPACE(sizeof(struct in_pktinfo))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = &to;
+  msg.msg_namelen = sizeof(to);
+  msg.msg_iov = iov;
+  msg.msg_iovlen = count;
+
+  if((uint32_t)sourceIP != 0)
+  {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = IPPROTO_IP;
+    c->cmsg_type = IP_PKTINFO;
+    c->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+    ((struct in_pktinfo*)CMSG_DATA(c))->ipi_spec_dst.s_addr = (uint32_t)sourceIP;
+  }
+
+  return (sendmsg(sock, &msg, 0) == (ssize_t)size) ? 1 : 0;
+}
+
+// **** Function HostUDP::sendBatch() ****
+// Descr: Sends count datagrams with a single sendmmsg() call (per ARTNET_HOST_BATCH), from sourceIP when one was set.
+//        A datagram the kernel refuses is skipped, the ones after it are still sent.
+// Return: the number of datagrams sent, -1 when the socket is not open.
+int HostUDP::sendBatch(const IPAddress *ip, uint16_t port, uint8_t *const *buffers, const uint16_t *sizes, int count)
+{
+  if(sock < 0)
+    return -1;
+
+  struct sockaddr_in to[ARTNET_HOST_BATCH];
+  struct iovec iov[ARTNET_HOST_BATCH];
+  struct mmsghdr msgs[ARTNET_HOST_BATCH];
+  uint8_t control[ARTNET_HOST_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+  int sent = 0;
+
+  for(int first=0 ; first < count ; first += ARTNET_HOST_BATCH)
+  {
+    int n = (count - first < ARTNET_HOST_BATCH) ? count - first : ARTNET_HOST_BATCH;
+    memset(msgs, 0, n * sizeof(struct mmsghdr));
+    for(int i=0 ; i < n ; i++)
+    {
+      memset(&to[i], 0, sizeof(to[i]));
+      to[i].sin_family = AF_INET;
+      to[i].sin_port = htons(port);
+      to[i].sin_addr.s_addr = (uint32_t)ip[first + i];
+      iov[i].iov_base = buffers[first + i];
+      iov[i].iov_len = sizes[first + i];
+
+      struct msghdr *msg = &msgs[i].msg_hdr;
+      msg->msg_name = &to[i];
+      msg->msg_namelen = sizeof(to[i]);
+      msg->msg_iov = &iov[i];
+      msg->msg_iovlen = 1;
+      if((uint32_t)sourceIP != 0)
+      {
+        memset(control[i], 0, sizeof(control[i]));
+        msg->msg_control = control[i];
+        msg->msg_controllen = sizeof(control[i]);
+        struct cmsghdr *c = CMSG_FIRSTHDR(msg);
+        c->cmsg_level = IPPROTO_IP;
+        c->cmsg_type = IP_PKTINFO;
+        c->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+        ((struct in_pktinfo*)CMSG_DATA(c))->ipi_spec_dst.s_addr = (uint32_t)sourceIP;
+      }
+    }
+
+    //sendmmsg() stops at the first datagram that fails, skip that one and go on with the rest.
+    for(int done=0 ; done < n ; )
+    {
+      int r = sendmmsg(sock, &msgs[done], n - done, 0);
+      if(r <= 0)
+      {
+        if(r < 0 && errno == EINTR)
+          continue;
+        done++;
+      }
+      else
+      {
+        sent += r;
+        done += r;
+      }
+    }
+  }
+  return sent;
+}
+
+// **** Function HostEthernetClass::begin(mac) ****
+// Descr: DHCP is handled by the OS, this looks up the first IPv4 address of an interface that is up and not loopback.
+// Return: 1 = an address was found ; 0 = no configured interface.
+int HostEthernetClass::begin(uint8_t *mac, unsigned long timeout, unsigned long responseTimeout)
+{
+  (void)mac; (void)timeout; (void)responseTimeout;
+
+  struct ifaddrs *list;
+  if(getifaddrs(&list) != 0)
+    return 0;
+
+  int found = 0;
+  for(struct ifaddrs *ifa = list ; ifa && !found ; ifa = ifa->ifa_next)
+  {
+    if(!ifa->ifa_addr || ifa->ifa_addr->sa_family != AF_INET)
+      continue;
+    if(!(ifa->ifa_flags & IFF_UP) || (ifa->ifa_flags & IFF_LOOPBACK))
+      continue;
+
+    ip = IPAddress((uint32_t)((struct sockaddr_in*)ifa->ifa_addr)->sin_addr.s_addr);
+    if(ifa->ifa_netmask)
+      subnet = IPAddress((uint32_t)((struct sockaddr_in*)ifa->ifa_netmask)->sin_addr.s_addr);
+    found = 1;
+  }
+  freeifaddrs(list);
+  return found;
+}
+
+void HostEthernetClass::begin(uint8_t *mac, IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet)
+{
+  (void)mac;
+  this->ip = ip;
+  this->dns = dns;
+  this->gateway = gateway;
+  this->subnet = subnet;
+}
+
+#endif
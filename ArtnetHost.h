@@ -0,0 +1,168 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Linux host backend (UNTESTED on other POSIX systems!)
+// Provides the few Arduino types the library relies on, a UDP socket with the EthernetUDP interface and
+// an Ethernet object that simply reports the address the OS network stack has configured.
+// Build the library with a regular C++ compiler, no Arduino core is needed.
+
+#ifndef ARTNET_HOST_H
+#define ARTNET_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define DEC                     10
+#define HEX                     16
+#define ARTNET_HOST_MTU         1500        // Largest datagram the host socket buffers.
+#define ARTNET_HOST_BATCH       64          // Most datagrams handed to the kernel in one sendBatch() call.
+
+uint32_t millis(void);
+uint32_t micros(void);
+void     delay(uint32_t ms);
+
+class IPAddress
+{
+  public:
+    IPAddress() { memset(addr, 0, 4); }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { addr[0] = a; addr[1] = b; addr[2] = c; addr[3] = d; }
+    IPAddress(const uint8_t *ip) { memcpy(addr, ip, 4); }
+    IPAddress(uint32_t ip) { memcpy(addr, &ip, 4); }             //ip in network byte order, as in sockaddr_in
+
+    operator uint32_t() const { uint32_t ip; memcpy(&ip, addr, 4); return ip; }
+    bool operator==(const IPAddress &ip) const { return memcmp(addr, ip.addr, 4) == 0; }
+    bool operator!=(const IPAddress &ip) const { return !(*this == ip); }
+    uint8_t operator[](int i) const { return addr[i]; }
+    uint8_t& operator[](int i) { return addr[i]; }
+    IPAddress& operator=(const uint8_t *ip) { memcpy(addr, ip, 4); return *this; }
+
+  private:
+    uint8_t addr[4];
+};
+
+// Byte sink with the write()/print() part of the Arduino Print interface, for dump targets.
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t print(const char *s) { return write((const uint8_t*)s, strlen(s)); }
+};
+
+// Serial is mapped on stdout so the DEBUG output of the library keeps working.
+class HostSerial : public Print
+{
+  public:
+    using  Print::write;
+    size_t write(const uint8_t *buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+    void   begin(unsigned long) {}
+    size_t print(const char *s) { return printf("%s", s); }
+    size_t print(char c) { return printf("%c", c); }
+    size_t print(long n, int base = DEC) { return (base == HEX) ? printf("%lX", n) : printf("%ld", n); }
+    size_t print(unsigned long n, int base = DEC) { return (base == HEX) ? printf("%lX", n) : printf("%lu", n); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(IPAddress ip) { return printf("%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]); }
+    size_t println(void) { return printf("\n"); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int base) { size_t n = print(v, base); return n + println(); }
+};
+extern HostSerial Serial;
+
+// UDP socket with the same interface as EthernetUDP/WiFiUDP.
+// A socket can be shared by several Artnet instances (see share()), every user sending from its own source address.
+class HostUDP
+{
+  public:
+    HostUDP();
+    ~HostUDP();
+
+    uint8_t   begin(uint16_t port);
+    uint8_t   begin(IPAddress ip, uint16_t port);
+    void      share(const HostUDP &udp, IPAddress source);
+    void      stop(void);
+
+    int       parsePacket(void);
+    int       read(uint8_t *buffer, size_t size);
+    IPAddress remoteIP(void) { return rxRemoteIP; }
+    uint16_t  remotePort(void) { return rxRemotePort; }
+    IPAddress destinationIP(void) { return rxDestIP; }
+
+    int       beginPacket(IPAddress ip, uint16_t port);
+    size_t    write(const uint8_t *buffer, size_t size);
+    int       endPacket(void);
+    int       sendGather(IPAddress ip, uint16_t port, const uint8_t *header, size_t headerSize, const uint8_t *data, size_t dataSize);
+    int       sendBatch(const IPAddress *ip, uint16_t port, uint8_t *const *buffers, const uint16_t *sizes, int count);
+
+  private:
+    HostUDP(const HostUDP&);
+    HostUDP& operator=(const HostUDP&);
+    int       sendVector(IPAddress ip, uint16_t port, struct iovec *iov, int count);
+
+    int       sock;
+    bool      owner;                  //Only the owner closes the socket.
+    IPAddress sourceIP;               //0.0.0.0 lets the kernel pick the source address.
+
+    uint8_t   rxBuffer[ARTNET_HOST_MTU];
+    uint16_t  rxSize;
+    uint16_t  rxOffset;
+    IPAddress rxRemoteIP;
+    uint16_t  rxRemotePort;
+    IPAddress rxDestIP;
+
+    uint8_t   txBuffer[ARTNET_HOST_MTU];
+    uint16_t  txSize;
+    IPAddress txIP;
+    uint16_t  txPort;
+};
+
+// Network configuration is done by the OS, begin() only records or looks up the address in use.
+class HostEthernetClass
+{
+  public:
+    void      init(uint8_t) {}
+    int       begin(uint8_t *mac, unsigned long timeout = 60000, unsigned long responseTimeout = 4000);
+    void      begin(uint8_t *mac, IPAddress ip, IPAddress dns = IPAddress(), IPAddress gateway = IPAddress(), IPAddress subnet = IPAddress());
+    int       maintain(void) { return 0; }
+    IPAddress localIP(void) { return ip; }
+    IPAddress subnetMask(void) { return subnet; }
+    IPAddress gatewayIP(void) { return gateway; }
+    IPAddress dnsServerIP(void) { return dns; }
+
+  private:
+    IPAddress ip, subnet, gateway, dns;
+};
+extern HostEthernetClass Ethernet;
+
+#endif
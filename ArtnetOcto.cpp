@@ -0,0 +1,127 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+// Wire order of the colour bytes for the OctoWS2811 colour configs (config & 7):
+// WS2811_RGB, WS2811_RBG, WS2811_GRB, WS2811_GBR, WS2811_BRG, WS2811_BGR
+static const uint8_t octoOrders[6][3] = {
+  {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+};
+
+// Stores the transposed word so its most significant byte lands first in memory.
+static inline uint32_t octoPlanes(uint32_t v)
+{
+  #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return v;
+  #else
+    return __builtin_bswap32(v);
+  #endif
+}
+
+ArtnetOcto::ArtnetOcto() : drawing(NULL), ledsPerStrip(0)
+{
+  memcpy(order, octoOrders[0], 3);
+  for(uint8_t s=0 ; s < ARTNET_OCTO_STRIPS ; s++)
+    strips[s] = NULL;
+}
+
+// **** Function ArtnetOcto::begin() ****
+// Descr: Sets the OctoWS2811 drawing memory to write to.
+// Argumenets: drawingMemory = the drawing memory given to OctoWS2811 (ledsPerStrip*6 ints), ledsPerStrip = as given to OctoWS2811,
+//             config = the OctoWS2811 config, only the colour order (e.g. WS2811_GRB) is used.
+// NOTE: This is the bit-plane layout OctoWS2811 uses on Teensy 3.x.
+void ArtnetOcto::begin(void *drawingMemory, uint16_t ledsPerStrip, uint8_t config)
+{
+  drawing = (uint8_t*)drawingMemory;
+  this->ledsPerStrip = ledsPerStrip;
+  memcpy(order, octoOrders[((config & 7) < 6) ? (config & 7) : 0], 3);
+}
+
+// **** Function ArtnetOcto::setStrip() ****
+// Descr: Sets where the RGB data of a strip is kept: ledsPerStrip*3 bytes in R, G, B order, as received in ArtDmx. NULL turns the strip off.
+void ArtnetOcto::setStrip(uint8_t strip, const uint8_t *rgb)
+{
+  if(strip < ARTNET_OCTO_STRIPS)
+    strips[strip] = rgb;
+}
+
+// **** Function ArtnetOcto::update() ****
+// Descr: Rebuilds the whole drawing memory, call OctoWS2811::show() afterwards.
+void ArtnetOcto::update()
+{
+  update(0, ledsPerStrip);
+}
+
+// **** Function ArtnetOcto::update(firstLed, numLeds) ****
+// Descr: Rebuilds the drawing memory of led positions [firstLed, firstLed+numLeds) on all strips.
+void ArtnetOcto::update(uint16_t firstLed, uint16_t numLeds)
+{
+  static const uint8_t off[3] = {0, 0, 0};
+
+  if(!drawing || firstLed >= ledsPerStrip)
+    return;
+  if(numLeds > ledsPerStrip - firstLed)
+    numLeds = ledsPerStrip - firstLed;
+
+  const uint8_t *src[ARTNET_OCTO_STRIPS];
+  uint8_t step[ARTNET_OCTO_STRIPS];
+  for(uint8_t s=0 ; s < ARTNET_OCTO_STRIPS ; s++)
+  {
+    src[s]  = strips[s] ? strips[s] + firstLed * 3 : off;
+    step[s] = strips[s] ? 3 : 0;
+  }
+
+  uint32_t *out = (uint32_t*)(drawing + firstLed * 24);
+  const uint8_t c0 = order[0], c1 = order[1], c2 = order[2];
+
+  for(uint16_t led=0 ; led < numLeds ; led++)
+  {
+    for(uint8_t j=0 ; j < 3 ; j++)
+    {
+      uint8_t c = (j == 0) ? c0 : (j == 1) ? c1 : c2;
+
+      //Rows of the 8x8 matrix are the strips, highest strip first, so the transposed rows hold bit n of strip n.
+      uint32_t x = ((uint32_t)src[7][c] << 24) | ((uint32_t)src[6][c] << 16) | ((uint32_t)src[5][c] << 8) | src[4][c];
+      uint32_t y = ((uint32_t)src[3][c] << 24) | ((uint32_t)src[2][c] << 16) | ((uint32_t)src[1][c] << 8) | src[0][c];
+      uint32_t t;
+
+      //8x8 bit-matrix transpose (Hacker's Delight, transpose8rS32).
+      t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+      t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+      t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+      t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+      t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+      y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+
+      *out++ = octoPlanes(t);
+      *out++ = octoPlanes(y);
+    }
+
+    for(uint8_t s=0 ; s < ARTNET_OCTO_STRIPS ; s++)
+      src[s] += step[s];
+  }
+}
@@ -0,0 +1,57 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// OctoWS2811 bit-plane writer.
+// OctoWS2811 keeps its drawing memory as bit-planes: for every led position 24 bytes, one per bit of the colour word
+// (most significant first, in wire order), where bit n of each byte belongs to strip n. setPixel() builds this one bit
+// at a time. ArtnetOcto builds it from RGB data of all 8 strips at once with 8x8 bit-matrix transposes over two words,
+// the colour order of the OctoWS2811 config is folded in. No dependency on OctoWS2811 itself.
+
+#ifndef ARTNET_OCTO_H
+#define ARTNET_OCTO_H
+
+// Included from Artnet.h
+
+#define   ARTNET_OCTO_STRIPS        8
+
+class ArtnetOcto
+{
+  public:
+    ArtnetOcto();
+
+    void begin(void *drawingMemory, uint16_t ledsPerStrip, uint8_t config);
+    void setStrip(uint8_t strip, const uint8_t *rgb);
+    void update(void);
+    void update(uint16_t firstLed, uint16_t numLeds);
+
+  private:
+    uint8_t       *drawing;
+    uint16_t       ledsPerStrip;
+    uint8_t        order[3];                       //Index of R, G or B for each colour byte on the wire.
+    const uint8_t *strips[ARTNET_OCTO_STRIPS];     //RGB data of each strip, NULL for a strip that is not used.
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+ArtnetPatch::ArtnetPatch() : output(NULL), size(0), numSegments(0), numOps(0), numUniverses(0) {}
+
+// **** Function ArtnetPatch::begin() ****
+// Descr: Sets the output buffer the patch writes to and clears all segments.
+void ArtnetPatch::begin(uint8_t *output, uint32_t size)
+{
+  this->output = output;
+  this->size = size;
+  numSegments = 0;
+  numOps = 0;
+  numUniverses = 0;
+}
+
+// **** Function ArtnetPatch::addSegment() ****
+// Descr: Patches pixels starting at channel of universe to the output, starting at byte offset. Call compile() once all segments are added.
+// Argumenets: universe = 15 bit Port-Address, channel = first DMX channel (0 based), pixels = number of pixels (may run into the next universes),
+//             offset = byte offset in the output, pixelSize = channels per pixel (1 to 4), stride = bytes between pixels in the output
+//             (0 = pixelSize, at most 0x7FFF), reverse = the first pixel goes to the end of the segment (serpentine layouts).
+// Return: segment number, -1 when the segment is invalid or there is no room left.
+int8_t ArtnetPatch::addSegment(uint16_t universe, uint16_t channel, uint16_t pixels, uint32_t offset, uint8_t pixelSize, uint16_t stride, bool reverse)
+{
+  if(numSegments >= ARTNET_PATCH_SEGMENTS || pixelSize == 0 || pixelSize > 4 || channel >= ARTNET_DMX_CHANNELS || pixels == 0)
+    return -1;
+  if(stride > 0x7FFF)             //A compiled op keeps the stride as a signed 16 bit step.
+    return -1;
+
+  struct patchSegment_s *seg = &segments[numSegments];
+  seg->universe  = universe;
+  seg->channel   = channel;
+  seg->pixels    = pixels;
+  seg->offset    = offset;
+  seg->pixelSize = pixelSize;
+  seg->stride    = stride ? stride : pixelSize;
+  seg->reverse   = reverse;
+  for(uint8_t c=0 ; c < 4 ; c++)
+    seg->order[c] = c;
+
+  return numSegments++;
+}
+
+// **** Function ArtnetPatch::setOrder() ****
+// Descr: Reorders the channels of every pixel of a segment, output byte n gets input channel cn. E.g. (1, 0, 2) turns RGB into GRB.
+void ArtnetPatch::setOrder(int8_t segment, uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3)
+{
+  if(segment < 0 || segment >= numSegments)
+    return;
+
+  struct patchSegment_s *seg = &segments[segment];
+  seg->order[0] = c0;
+  seg->order[1] = c1;
+  seg->order[2] = c2;
+  seg->order[3] = c3;
+  for(uint8_t c=0 ; c < seg->pixelSize ; c++)
+    if(seg->order[c] >= seg->pixelSize)
+      seg->order[c] = c;
+}
+
+// **** Function ArtnetPatch::addOp() ****
+// Descr: Adds the operation for pixels [first, first+pixels) of a segment, received at src in universe.
+// Return: 1 = success ; 0 = out of the output buffer or no room left.
+uint8_t ArtnetPatch::addOp(struct patchSegment_s *seg, uint16_t universe, uint16_t src, uint16_t first, uint16_t pixels)
+{
+  if(numOps >= ARTNET_PATCH_OPS)
+    return 0;
+
+  struct patchOp_s *op = &ops[numOps];
+  uint32_t position = seg->reverse ? seg->pixels - 1 - first : first;
+  op->universe  = universe;
+  op->src       = src;
+  op->dst       = seg->offset + position * seg->stride;
+  op->pixels    = pixels;
+  op->step      = seg->reverse ? -(int16_t)seg->stride : seg->stride;
+  op->pixelSize = seg->pixelSize;
+  memcpy(op->order, seg->order, 4);
+
+  bool inOrder = true;
+  for(uint8_t c=0 ; c < seg->pixelSize ; c++)
+    inOrder &= (seg->order[c] == c);
+  op->copy = !seg->reverse && seg->stride == seg->pixelSize && inOrder;
+
+  //The last pixel written is the highest address for forward ops, the first one for reversed ops.
+  uint32_t highest = seg->reverse ? op->dst : op->dst + (uint32_t)(pixels - 1) * seg->stride;
+  if(highest + seg->pixelSize > size)
+    return 0;
+
+  numOps++;
+  return 1;
+}
+
+// **** Function ArtnetPatch::compile() ****
+// Descr: Turns the segments into the list of copy operations used by apply().
+// Return: number of operations, 0 when a segment does not fit the output or there are too many operations.
+uint8_t ArtnetPatch::compile()
+{
+  numOps = 0;
+  numUniverses = 0;
+
+  //Split every segment in one operation per universe, on whole pixels.
+  for(uint8_t i=0 ; i < numSegments ; i++)
+  {
+    struct patchSegment_s *seg = &segments[i];
+    uint16_t universe = seg->universe;
+    uint16_t channel = seg->channel;
+    uint16_t done = 0;
+
+    while(done < seg->pixels)
+    {
+      uint16_t fit = (ARTNET_DMX_CHANNELS - channel) / seg->pixelSize;
+      uint16_t n = (seg->pixels - done < fit) ? seg->pixels - done : fit;
+      if(n && !addOp(seg, universe, channel, done, n))
+      {
+        numOps = 0;
+        return 0;
+      }
+      done += n;
+      universe++;
+      channel = 0;
+    }
+  }
+
+  //Sort on universe, then on source channel.
+  for(uint8_t i=1 ; i < numOps ; i++)
+  {
+    struct patchOp_s op = ops[i];
+    int16_t j = i - 1;
+    while(j >= 0 && (ops[j].universe > op.universe || (ops[j].universe == op.universe && ops[j].src > op.src)))
+    {
+      ops[j+1] = ops[j];
+      j--;
+    }
+    ops[j+1] = op;
+  }
+
+  //Merge plain copies that are contiguous in both the DMX data and the output.
+  uint8_t count = 0;
+  for(uint8_t i=0 ; i < numOps ; i++)
+  {
+    struct patchOp_s *last = count ? &ops[count-1] : NULL;
+    uint16_t bytes = last ? last->pixels * last->pixelSize : 0;
+    if(last && last->copy && ops[i].copy && last->universe == ops[i].universe && last->pixelSize == ops[i].pixelSize
+       && last->src + bytes == ops[i].src && last->dst + bytes == ops[i].dst)
+      last->pixels += ops[i].pixels;
+    else
+      ops[count++] = ops[i];
+  }
+  numOps = count;
+
+  //Index of the first operation of every universe.
+  for(uint8_t i=0 ; i < numOps ; i++)
+  {
+    if(numUniverses && universes[numUniverses-1].universe == ops[i].universe)
+    {
+      universes[numUniverses-1].count++;
+    }
+    else
+    {
+      universes[numUniverses].universe = ops[i].universe;
+      universes[numUniverses].first = i;
+      universes[numUniverses].count = 1;
+      numUniverses++;
+    }
+  }
+
+  return numOps;
+}
+
+// **** Function ArtnetPatch::apply() ****
+// Descr: Copies the patched channels of a received universe to the output. Short packets only update the pixels they carry.
+//        Called by Artnet::read() for every ArtDmx packet once the patch is attached with Artnet::setPatch().
+// Return: number of bytes written to the output.
+uint16_t ArtnetPatch::apply(uint16_t universe, uint16_t length, const uint8_t *data)
+{
+  //Binary search of the universe.
+  int16_t low = 0, high = numUniverses - 1, found = -1;
+  while(low <= high)
+  {
+    int16_t mid = (low + high) / 2;
+    if(universes[mid].universe == universe)
+    {
+      found = mid;
+      break;
+    }
+    if(universes[mid].universe < universe)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+  if(found < 0)
+    return 0;
+
+  if(length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS;
+
+  uint16_t written = 0;
+  struct patchOp_s *op = &ops[universes[found].first];
+  for(uint8_t i=0 ; i < universes[found].count ; i++, op++)
+  {
+    if(op->src >= length)
+      continue;
+    uint16_t pixels = (length - op->src) / op->pixelSize;
+    if(pixels > op->pixels)
+      pixels = op->pixels;
+
+    if(op->copy)
+    {
+      memcpy(output + op->dst, data + op->src, pixels * op->pixelSize);
+    }
+    else
+    {
+      uint8_t *d = output + op->dst;
+      const uint8_t *s = data + op->src;
+      for(uint16_t p=0 ; p < pixels ; p++, d += op->step, s += op->pixelSize)
+        for(uint8_t c=0 ; c < op->pixelSize ; c++)
+          d[c] = s[op->order[c]];
+    }
+    written += pixels * op->pixelSize;
+  }
+  return written;
+}
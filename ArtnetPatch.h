@@ -0,0 +1,97 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Universe to output patch map.
+// Segments describe where pixels of a universe go in an output buffer (pixel size, stride, reversal for serpentine
+// layouts and channel order). compile() turns them into a flat list of copy operations sorted by universe, so every
+// ArtDmx packet is handled with a lookup and a few memcpy's. A segment may span several universes, it is split on
+// whole pixels (170 RGB or 128 RGBW pixels per universe).
+
+#ifndef ARTNET_PATCH_H
+#define ARTNET_PATCH_H
+
+// Included from Artnet.h
+
+#ifndef ARTNET_PATCH_SEGMENTS
+    #define ARTNET_PATCH_SEGMENTS   16          // Maximum number of segments.
+#endif
+#ifndef ARTNET_PATCH_OPS
+    #define ARTNET_PATCH_OPS        64          // Maximum number of compiled operations (one per segment per universe).
+#endif
+
+class ArtnetPatch
+{
+  public:
+    ArtnetPatch();
+
+    void     begin(uint8_t *output, uint32_t size);
+    int8_t   addSegment(uint16_t universe, uint16_t channel, uint16_t pixels, uint32_t offset, uint8_t pixelSize = 3, uint16_t stride = 0, bool reverse = false);
+    void     setOrder(int8_t segment, uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3 = 3);
+    uint8_t  compile(void);
+    uint16_t apply(uint16_t universe, uint16_t length, const uint8_t *data);
+
+  private:
+    struct patchSegment_s {
+      uint16_t  universe;
+      uint16_t  channel;                      //First DMX channel, 0 based.
+      uint16_t  pixels;
+      uint32_t  offset;                       //Byte offset of the first pixel in the output.
+      uint8_t   pixelSize;                    //Channels per pixel, 1 to 4.
+      uint16_t  stride;                       //Bytes between pixels in the output.
+      bool      reverse;
+      uint8_t   order[4];                     //Output byte n of a pixel is input byte order[n].
+    };
+
+    struct patchOp_s {
+      uint16_t  universe;
+      uint16_t  src;                          //Offset in the DMX data.
+      uint32_t  dst;                          //Offset in the output of the first pixel.
+      uint16_t  pixels;
+      int16_t   step;                         //Bytes between pixels in the output, negative when reversed.
+      uint8_t   pixelSize;
+      bool      copy;                         //Contiguous and in order: one memcpy.
+      uint8_t   order[4];
+    };
+
+    struct patchUniverse_s {
+      uint16_t  universe;
+      uint8_t   first;                        //First op of this universe.
+      uint8_t   count;
+    };
+
+    uint8_t  *output;
+    uint32_t  size;
+    struct patchSegment_s segments[ARTNET_PATCH_SEGMENTS];
+    struct patchOp_s ops[ARTNET_PATCH_OPS];
+    struct patchUniverse_s universes[ARTNET_PATCH_OPS];
+    uint8_t   numSegments;
+    uint8_t   numOps;
+    uint8_t   numUniverses;
+
+    uint8_t  addOp(struct patchSegment_s *seg, uint16_t universe, uint16_t src, uint16_t first, uint16_t pixels);
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+#if ARTNET_QUEUE
+
+ArtnetQueue::ArtnetQueue() : turn(ARTNET_QUEUE_REPLY)
+{
+  for(uint16_t i=0 ; i < ARTNET_QUEUE_REPLIES ; i++)
+    packets[i].data = replyPool[i];
+  for(uint16_t i=0 ; i < ARTNET_QUEUE_DMX ; i++)
+    packets[ARTNET_QUEUE_REPLIES + i].data = dmxPool[i];
+
+  rings[ARTNET_QUEUE_REPLY].packets = &packets[0];
+  rings[ARTNET_QUEUE_REPLY].slots = ARTNET_QUEUE_REPLIES;
+  rings[ARTNET_QUEUE_DATA].packets = &packets[ARTNET_QUEUE_REPLIES];
+  rings[ARTNET_QUEUE_DATA].slots = ARTNET_QUEUE_DMX;
+  clear();
+}
+
+// **** Function ArtnetQueue::clear() ****
+// Descr: Drops all waiting packets.
+void ArtnetQueue::clear()
+{
+  for(uint8_t c=0 ; c < ARTNET_QUEUE_CLASSES ; c++)
+  {
+    rings[c].head = 0;
+    rings[c].count = 0;
+  }
+}
+
+// **** Function ArtnetQueue::reserve() ****
+// Descr: Returns the next free slot of a class to build a packet in (ART_SIZE_POLLREPLY bytes for replies,
+//        ART_SIZE_DMX for data). It is only queued by commit().
+// Return: the slot, NULL when the pool of the class is full.
+uint8_t* ArtnetQueue::reserve(uint8_t priority)
+{
+  struct queueRing_s *r = &rings[priority];
+  if(r->count == r->slots)
+    return NULL;
+
+  uint16_t tail = r->head + r->count;
+  if(tail >= r->slots)
+    tail -= r->slots;
+  return r->packets[tail].data;
+}
+
+// **** Function ArtnetQueue::commit() ****
+// Descr: Queues the packet built in the slot returned by reserve().
+void ArtnetQueue::commit(uint8_t priority, IPAddress ip, uint16_t size)
+{
+  struct queueRing_s *r = &rings[priority];
+  uint16_t tail = r->head + r->count;
+  if(tail >= r->slots)
+    tail -= r->slots;
+
+  r->packets[tail].ip = ip;
+  r->packets[tail].size = size;
+  r->count++;
+}
+
+// **** Function ArtnetQueue::push() ****
+// Descr: Copies a packet into the pool of a class and queues it.
+// Return: 1 = queued ; 0 = the pool is full or the packet is too large for it.
+uint8_t ArtnetQueue::push(uint8_t priority, IPAddress ip, const uint8_t *packet, uint16_t size)
+{
+  uint16_t slotSize = (priority == ARTNET_QUEUE_REPLY) ? ART_SIZE_POLLREPLY : ART_SIZE_DMX;
+  uint8_t *slot = reserve(priority);
+  if(!slot || size > slotSize)
+    return 0;
+
+  memcpy(slot, packet, size);
+  commit(priority, ip, size);
+  return 1;
+}
+
+// **** Function ArtnetQueue::pop() ****
+// Descr: Takes up to max packets off the queue, the classes take turns. The packets stay valid until the next reserve().
+// Return: the number of packets put in batch.
+uint8_t ArtnetQueue::pop(struct queuePacket_s **batch, uint8_t max)
+{
+  uint8_t n = 0;
+  while(n < max && count())
+  {
+    struct queueRing_s *r = &rings[turn];
+    turn = (turn + 1) % ARTNET_QUEUE_CLASSES;
+    if(!r->count)
+      continue;
+
+    batch[n++] = &r->packets[r->head];
+    if(++r->head == r->slots)
+      r->head = 0;
+    r->count--;
+  }
+  return n;
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Outbound send queue.
+// Packets the node sends (ArtPollReply, ArtDmx from sendDmx(), ...) are copied into a preallocated pool and sent later
+// from read(), at most ARTNET_QUEUE_BATCH per call, so answering a poll no longer blocks the receive loop for
+// ART_NUM_UNIVERSES sends in a row. Replies and DMX have their own pool and are sent in turns, neither can starve or
+// crowd out the other. On the Linux host a batch is sent with a single sendmmsg() call.
+// On microcontrollers the DMX pool holds a single packet to save RAM. AVR boards do not have the RAM for the pools at
+// all, there the queue is off unless ARTNET_QUEUE is defined as 1 and packets are sent on the spot like before.
+
+#ifndef ARTNET_QUEUE_H
+#define ARTNET_QUEUE_H
+
+// Included from Artnet.h
+
+#ifndef ARTNET_QUEUE
+  #if defined(__AVR__)
+    #define ARTNET_QUEUE            0
+  #else
+    #define ARTNET_QUEUE            1           // 1 = packets are queued and sent from read() ; 0 = sent on the spot.
+  #endif
+#endif
+
+#if ARTNET_QUEUE
+
+#ifndef ARTNET_QUEUE_REPLIES
+    #define ARTNET_QUEUE_REPLIES    (2 * ART_NUM_UNIVERSES)     // Reply packets that can wait, one poll answer is ART_NUM_UNIVERSES packets.
+#endif
+#ifndef ARTNET_QUEUE_DMX
+  #if defined(ARTNET_HOST)
+    #define ARTNET_QUEUE_DMX        16          // ArtDmx packets that can wait.
+  #else
+    #define ARTNET_QUEUE_DMX        1
+  #endif
+#endif
+#ifndef ARTNET_QUEUE_BATCH
+  #if defined(ARTNET_HOST)
+    #define ARTNET_QUEUE_BATCH      32          // Packets sent per read().
+  #else
+    #define ARTNET_QUEUE_BATCH      1
+  #endif
+#endif
+
+// Priority classes
+#define   ARTNET_QUEUE_REPLY        0           // ArtPollReply and other answers to a controller.
+#define   ARTNET_QUEUE_DATA         1           // ArtDmx output.
+#define   ARTNET_QUEUE_CLASSES      2
+
+struct queuePacket_s {
+  IPAddress   ip;                             //Destination.
+  uint16_t    size;
+  uint8_t    *data;                           //Slot in the pool of the class.
+};
+
+class ArtnetQueue
+{
+  public:
+    ArtnetQueue();
+
+    uint8_t* reserve(uint8_t priority);
+    void     commit(uint8_t priority, IPAddress ip, uint16_t size);
+    uint8_t  push(uint8_t priority, IPAddress ip, const uint8_t *packet, uint16_t size);
+    uint8_t  pop(struct queuePacket_s **batch, uint8_t max);
+    void     clear(void);
+
+    // **** Function ArtnetQueue::available() ****
+    // Descr: Returns the number of free slots in the pool of a class.
+    inline uint16_t available(uint8_t priority)
+    {
+      return rings[priority].slots - rings[priority].count;
+    }
+
+    // **** Function ArtnetQueue::count() ****
+    // Descr: Returns the number of packets waiting to be sent.
+    inline uint16_t count(void)
+    {
+      return rings[ARTNET_QUEUE_REPLY].count + rings[ARTNET_QUEUE_DATA].count;
+    }
+
+  private:
+    struct queueRing_s {
+      struct queuePacket_s *packets;
+      uint16_t  slots;
+      uint16_t  head;                         //Oldest packet.
+      uint16_t  count;
+    } rings[ARTNET_QUEUE_CLASSES];
+    uint8_t   turn;                           //Class that sends first in the next pop().
+
+    struct queuePacket_s packets[ARTNET_QUEUE_REPLIES + ARTNET_QUEUE_DMX];
+    uint8_t   replyPool[ARTNET_QUEUE_REPLIES][ART_SIZE_POLLREPLY];
+    uint8_t   dmxPool[ARTNET_QUEUE_DMX][ART_SIZE_DMX];
+};
+
+#endif
+
+#endif
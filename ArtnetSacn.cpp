@@ -0,0 +1,243 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+static const uint8_t sacnPacketId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+static inline void sacnPut16(uint8_t *p, uint16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v;
+}
+
+static inline void sacnPut32(uint8_t *p, uint32_t v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+ArtnetSacn::ArtnetSacn() : priority(SACN_DEFAULT_PRIORITY), syncAddress(0), syncSequence(0), universeOffset(1)
+{
+  memset(universes, 0, sizeof(universes));
+  memset(cid, 0, sizeof(cid));
+  memset(sourceName, 0, sizeof(sourceName));
+}
+
+// **** Function ArtnetSacn::begin() ****
+// Descr: Opens the sACN socket. Attach the gateway to a node with Artnet::setGateway().
+// Argumenets: mac[] = used to derive a stable CID, sourceName = the E1.31 source name (max 63 characters),
+//             universeOffset = sACN universe minus Port-Address (default 1, sACN has no universe 0).
+// Return: 1 = success ; 0 = the socket could not be opened.
+uint8_t ArtnetSacn::begin(byte mac[], const char *sourceName, int16_t universeOffset)
+{
+  //CID: a fixed prefix followed by the mac address, so the gateway keeps its identity across reboots.
+  const uint8_t prefix[10] = {'A', 'r', 't', '-', 'N', 'e', 't', 0x40, 0x80, 0x00};
+  memcpy(cid, prefix, 10);
+  memcpy(cid + 10, mac, 6);
+
+  strncpy(this->sourceName, sourceName, sizeof(this->sourceName) - 1);
+  this->universeOffset = universeOffset;
+
+  for(uint16_t i=0 ; i < ARTNET_SACN_UNIVERSES ; i++)
+    universes[i].used = false;
+
+  return Udp.begin(SACN_PORT);
+}
+
+// **** Function ArtnetSacn::setPriority() ****
+// Descr: Sets the E1.31 priority (0 to 200) of all universes.
+void ArtnetSacn::setPriority(uint8_t priority)
+{
+  this->priority = (priority > 200) ? 200 : priority;
+  for(uint16_t i=0 ; i < ARTNET_SACN_UNIVERSES ; i++)
+    if(universes[i].used)
+      universes[i].header[108] = this->priority;
+}
+
+// **** Function ArtnetSacn::setSyncAddress() ****
+// Descr: Sets the sACN universe used for synchronization. Receivers hold the data until the synchronization packet,
+//        which is sent for every ArtSync. 0 disables synchronization.
+void ArtnetSacn::setSyncAddress(uint16_t universe)
+{
+  syncAddress = universe;
+  for(uint16_t i=0 ; i < ARTNET_SACN_UNIVERSES ; i++)
+    if(universes[i].used)
+      sacnPut16(&universes[i].header[109], syncAddress);
+}
+
+// **** Function ArtnetSacn::setUnicast() ****
+// Descr: Sends all universes to ip instead of to their multicast groups. 0.0.0.0 goes back to multicast.
+void ArtnetSacn::setUnicast(IPAddress ip)
+{
+  unicastIP = ip;
+}
+
+// **** Function ArtnetSacn::lookup() ****
+// Descr: Finds the slot of a Port-Address, a new slot gets its header built. Open addressing on the Port-Address.
+// Return: the slot, NULL when the table is full.
+struct sacnUniverse_s* ArtnetSacn::lookup(uint16_t universe)
+{
+  uint16_t i = universe & (ARTNET_SACN_UNIVERSES - 1);
+  for(uint16_t n=0 ; n < ARTNET_SACN_UNIVERSES ; n++, i = (i + 1) & (ARTNET_SACN_UNIVERSES - 1))
+  {
+    if(universes[i].used && universes[i].artnet == universe)
+      return &universes[i];
+
+    if(!universes[i].used)
+    {
+      universes[i].used = true;
+      universes[i].artnet = universe;
+      universes[i].sequence = 0;
+      buildHeader(&universes[i]);
+      return &universes[i];
+    }
+  }
+  return NULL;
+}
+
+// **** Function ArtnetSacn::buildHeader() ****
+// Descr: Builds the E1.31 root, framing and DMP layer of a universe, for a full universe of 512 slots.
+void ArtnetSacn::buildHeader(struct sacnUniverse_s *u)
+{
+  uint8_t *h = u->header;
+  memset(h, 0, SACN_HEADER_SIZE);
+
+  //Root layer
+  sacnPut16(&h[0], 0x0010);                          //Preamble size
+  sacnPut16(&h[2], 0x0000);                          //Post-amble size
+  memcpy(&h[4], sacnPacketId, 12);
+  sacnPut32(&h[18], SACN_VECTOR_ROOT_DATA);
+  memcpy(&h[22], cid, 16);
+
+  //Framing layer
+  sacnPut32(&h[40], SACN_VECTOR_FRAME_DATA);
+  memcpy(&h[44], sourceName, 64);
+  h[108] = priority;
+  sacnPut16(&h[109], syncAddress);
+  h[111] = 0;                                        //Sequence number, patched per packet
+  h[112] = 0;                                        //Options
+  sacnPut16(&h[113], u->artnet + universeOffset);
+
+  //DMP layer
+  h[117] = SACN_VECTOR_DMP_SET;
+  h[118] = 0xA1;                                     //Address type & data type
+  sacnPut16(&h[119], 0x0000);                        //First property address
+  sacnPut16(&h[121], 0x0001);                        //Address increment
+  h[125] = 0x00;                                     //DMX start code
+
+  setLength(u, ARTNET_DMX_CHANNELS);
+}
+
+// **** Function ArtnetSacn::setLength() ****
+// Descr: Patches the flags & length fields of all three layers and the property value count for length DMX slots.
+void ArtnetSacn::setLength(struct sacnUniverse_s *u, uint16_t length)
+{
+  uint8_t *h = u->header;
+  uint16_t total = SACN_HEADER_SIZE + length;
+
+  sacnPut16(&h[16], 0x7000 | (total - 16));
+  sacnPut16(&h[38], 0x7000 | (total - 38));
+  sacnPut16(&h[115], 0x7000 | (total - 115));
+  sacnPut16(&h[123], length + 1);
+  u->length = length;
+}
+
+// **** Function ArtnetSacn::destination() ****
+// Descr: Returns the multicast group of a sACN universe (239.255.hi.lo), or the unicast receiver when one is set.
+IPAddress ArtnetSacn::destination(uint16_t universe)
+{
+  if((uint32_t)unicastIP != 0)
+    return unicastIP;
+  return IPAddress(239, 255, universe >> 8, universe & 0xFF);
+}
+
+// **** Function ArtnetSacn::forward() ****
+// Descr: Sends an ArtDmx universe as E1.31 data packet. Called by Artnet::read() once the gateway is attached.
+// Return: 1 = sent ; 0 = not sent (invalid universe, no free slot or the send failed).
+uint8_t ArtnetSacn::forward(uint16_t universe, uint16_t length, uint8_t *data)
+{
+  int32_t sacnUniverse = (int32_t)universe + universeOffset;
+  if(sacnUniverse < 1 || sacnUniverse > 63999 || length == 0)
+    return 0;
+  if(length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS;
+
+  struct sacnUniverse_s *u = lookup(universe);
+  if(!u)
+    return 0;
+
+  if(u->length != length)
+    setLength(u, length);
+  u->header[111] = u->sequence++;
+
+  return send(destination(sacnUniverse), u->header, SACN_HEADER_SIZE, data, length);
+}
+
+// **** Function ArtnetSacn::sync() ****
+// Descr: Sends an E1.31 synchronization packet to the sync address. Called by Artnet::read() for every ArtSync.
+// Return: 1 = sent ; 0 = synchronization disabled or the send failed.
+uint8_t ArtnetSacn::sync()
+{
+  if(!syncAddress)
+    return 0;
+
+  uint8_t packet[SACN_SYNC_SIZE];
+  memset(packet, 0, sizeof(packet));
+
+  //Root layer
+  sacnPut16(&packet[0], 0x0010);
+  memcpy(&packet[4], sacnPacketId, 12);
+  sacnPut16(&packet[16], 0x7000 | (SACN_SYNC_SIZE - 16));
+  sacnPut32(&packet[18], SACN_VECTOR_ROOT_EXTENDED);
+  memcpy(&packet[22], cid, 16);
+
+  //Synchronization framing layer
+  sacnPut16(&packet[38], 0x7000 | (SACN_SYNC_SIZE - 38));
+  sacnPut32(&packet[40], SACN_VECTOR_FRAME_SYNC);
+  packet[44] = syncSequence++;
+  sacnPut16(&packet[45], syncAddress);
+
+  return send(destination(syncAddress), packet, SACN_SYNC_SIZE, NULL, 0);
+}
+
+// **** Function ArtnetSacn::send() ****
+// Descr: Sends header followed by data as one datagram, without copying them together first.
+// Return: 1 = success , 0 = fail
+uint8_t ArtnetSacn::send(IPAddress ip, uint8_t *header, uint16_t headerSize, uint8_t *data, uint16_t dataSize)
+{
+  #if defined(ARTNET_HOST)
+    return Udp.sendGather(ip, SACN_PORT, header, headerSize, data, dataSize);
+  #else
+    Udp.beginPacket(ip, SACN_PORT);
+    Udp.write(header, headerSize);
+    if(dataSize)
+      Udp.write(data, dataSize);
+    return Udp.endPacket();
+  #endif
+}
@@ -0,0 +1,102 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Art-Net to sACN (ANSI E1.31) gateway.
+// Every ArtDmx accepted by Artnet::read() is sent on as an E1.31 data packet, multicast to 239.255.hi.lo of its sACN
+// universe (or unicast, see setUnicast()). The E1.31 header of a universe is built once, per packet only the sequence
+// number (and the length fields when the slot count changes) are patched, the DMX data is sent straight from the
+// Art-Net receive buffer. ArtSync is forwarded as an E1.31 synchronization packet.
+// NOTE: W5x00 chips ARP for every destination, multicast sending on them needs a socket per group. Use setUnicast() there.
+
+#ifndef ARTNET_SACN_H
+#define ARTNET_SACN_H
+
+// Included from Artnet.h
+
+#ifndef ARTNET_SACN_UNIVERSES
+  #if defined(ARTNET_HOST)
+    #define ARTNET_SACN_UNIVERSES   512         // Universes the gateway can forward, must be a power of 2.
+  #else
+    #define ARTNET_SACN_UNIVERSES   8
+  #endif
+#endif
+
+#define   SACN_PORT                 5568        // ACN SDT multicast port.
+#define   SACN_HEADER_SIZE          126         // Root, framing and DMP layer up to and including the start code.
+#define   SACN_SYNC_SIZE            49          // Size of an E1.31 synchronization packet.
+#define   SACN_DEFAULT_PRIORITY     100
+#define   SACN_VECTOR_ROOT_DATA     0x00000004
+#define   SACN_VECTOR_ROOT_EXTENDED 0x00000008
+#define   SACN_VECTOR_FRAME_DATA    0x00000002
+#define   SACN_VECTOR_FRAME_SYNC    0x00000001
+#define   SACN_VECTOR_DMP_SET       0x02
+
+struct sacnUniverse_s {
+  uint16_t    artnet;                         //Port-Address the slot is used for.
+  uint16_t    length;                         //DMX slot count the length fields in header are set for.
+  uint8_t     sequence;
+  bool        used;
+  uint8_t     header[SACN_HEADER_SIZE];       //Prebuilt E1.31 header.
+};
+
+class ArtnetSacn
+{
+  public:
+    ArtnetSacn();
+
+    uint8_t begin(byte mac[], const char *sourceName, int16_t universeOffset = 1);
+    void    setPriority(uint8_t priority);
+    void    setSyncAddress(uint16_t universe);
+    void    setUnicast(IPAddress ip);
+    uint8_t forward(uint16_t universe, uint16_t length, uint8_t *data);
+    uint8_t sync(void);
+
+  private:
+    #if defined(ARDUINO_SAMD_ZERO) || defined(ESP8266) || defined(ESP32)
+      WiFiUDP Udp;
+    #elif defined(ARTNET_HOST)
+      HostUDP Udp;
+    #else
+      EthernetUDP Udp;
+    #endif
+
+    struct sacnUniverse_s universes[ARTNET_SACN_UNIVERSES];
+    uint8_t   cid[16];                        //Component identifier, derived from the mac address.
+    char      sourceName[64];
+    uint8_t   priority;
+    uint16_t  syncAddress;                    //0 = no synchronization.
+    uint8_t   syncSequence;
+    int16_t   universeOffset;                 //sACN universe = Port-Address + universeOffset.
+    IPAddress unicastIP;                      //0.0.0.0 = multicast.
+
+    struct sacnUniverse_s* lookup(uint16_t universe);
+    void    buildHeader(struct sacnUniverse_s *u);
+    void    setLength(struct sacnUniverse_s *u, uint16_t length);
+    IPAddress destination(uint16_t universe);
+    uint8_t send(IPAddress ip, uint8_t *header, uint16_t headerSize, uint8_t *data, uint16_t dataSize);
+};
+
+#endif
@@ -0,0 +1,263 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+#if defined(ARTNET_HOST)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Seqlock writer side: the sequence is odd while the data it guards is written.
+static inline void shmWriteBegin(uint32_t *sequence)
+{
+  __atomic_store_n(sequence, *sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void shmWriteEnd(uint32_t *sequence)
+{
+  __atomic_store_n(sequence, *sequence + 1, __ATOMIC_RELEASE);
+}
+
+ArtnetShm::ArtnetShm() : header(NULL), slots(NULL), size(0), writer(false), synchronous(false), lastSync(0)
+{
+  memset(pending, 0, sizeof(pending));
+}
+
+ArtnetShm::~ArtnetShm()
+{
+  end();
+}
+
+// **** Function ArtnetShm::begin() ****
+// Descr: Creates (or resets) the shared memory object name and maps it for writing. Attach it to a node with
+//        Artnet::setShm(), the node then publishes every ArtDmx and ArtSync it receives.
+// Return: 1 = success ; 0 = the object could not be created or mapped.
+uint8_t ArtnetShm::begin(const char *name)
+{
+  end();
+
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if(fd < 0)
+    return 0;
+
+  size = sizeof(struct shmHeader_s) + ARTNET_SHM_UNIVERSES * sizeof(struct shmUniverse_s);
+  void *p = MAP_FAILED;
+  if(ftruncate(fd, size) == 0)
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED)
+    return 0;
+
+  header = (struct shmHeader_s*)p;
+  slots = (struct shmUniverse_s*)(header + 1);
+  writer = true;
+
+  //Readers check the magic, so it is written last.
+  memset(p, 0, size);
+  header->version = ARTNET_SHM_VERSION;
+  header->universes = ARTNET_SHM_UNIVERSES;
+  header->slotSize = sizeof(struct shmUniverse_s);
+  __atomic_store_n(&header->magic, ARTNET_SHM_MAGIC, __ATOMIC_RELEASE);
+
+  memset(pending, 0, sizeof(pending));
+  synchronous = false;
+  return 1;
+}
+
+// **** Function ArtnetShm::open() ****
+// Descr: Maps the shared memory object name read only, for a reading process.
+// Return: 1 = success ; 0 = the object does not exist (yet) or has an other layout.
+uint8_t ArtnetShm::open(const char *name)
+{
+  end();
+
+  int fd = shm_open(name, O_RDONLY, 0);
+  if(fd < 0)
+    return 0;
+
+  struct stat st;
+  void *p = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(struct shmHeader_s))
+    p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED)
+    return 0;
+
+  header = (struct shmHeader_s*)p;
+  slots = (struct shmUniverse_s*)(header + 1);
+  size = st.st_size;
+
+  if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != ARTNET_SHM_MAGIC || header->version != ARTNET_SHM_VERSION ||
+     header->slotSize != sizeof(struct shmUniverse_s) || sizeof(struct shmHeader_s) + header->universes * sizeof(struct shmUniverse_s) > size)
+  {
+    end();
+    return 0;
+  }
+  return 1;
+}
+
+// **** Function ArtnetShm::end() ****
+// Descr: Unmaps the region. The shared memory object itself is kept, readers that mapped it keep the last frame.
+void ArtnetShm::end()
+{
+  if(header)
+    munmap(header, size);
+  header = NULL;
+  slots = NULL;
+  size = 0;
+  writer = false;
+}
+
+// **** Function ArtnetShm::lookup() ****
+// Descr: Finds the slot of a Port-Address with open addressing. With create a free slot is taken for a new universe.
+// Return: the slot, NULL when it is not found or the region is full.
+struct shmUniverse_s* ArtnetShm::lookup(uint16_t universe, bool create)
+{
+  if(!header)
+    return NULL;
+
+  uint16_t mask = header->universes - 1;
+  uint16_t i = universe & mask;
+  for(uint16_t n=0 ; n < header->universes ; n++, i = (i + 1) & mask)
+  {
+    struct shmUniverse_s *u = &slots[i];
+    if(__atomic_load_n(&u->used, __ATOMIC_ACQUIRE))
+    {
+      if(u->universe == universe)
+        return u;
+      continue;
+    }
+
+    if(!create)
+      return NULL;
+    u->universe = universe;
+    __atomic_store_n(&u->used, 1, __ATOMIC_RELEASE);
+    return u;
+  }
+  return NULL;
+}
+
+// **** Function ArtnetShm::find() ****
+// Descr: Returns the slot of a Port-Address, for readers. Read it between beginRead() and endRead().
+// Return: the slot, NULL when the universe was not received yet.
+const struct shmUniverse_s* ArtnetShm::find(uint16_t universe)
+{
+  return lookup(universe, false);
+}
+
+// **** Function ArtnetShm::publish() ****
+// Descr: Writes the data of a universe into its slot, guarded by the seqlock of the slot.
+void ArtnetShm::publish(struct shmUniverse_s *u, uint16_t length, uint8_t sequence, const uint8_t *data, uint32_t frame)
+{
+  shmWriteBegin(&u->sequence);
+  memcpy(u->data, data, length);
+  u->length = length;
+  u->artSequence = sequence;
+  u->frame = frame;
+  u->time = millis();
+  shmWriteEnd(&u->sequence);
+}
+
+// **** Function ArtnetShm::update() ****
+// Descr: Publishes an ArtDmx universe, or stages it for the next ArtSync. Called by Artnet::read() once attached.
+void ArtnetShm::update(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *data)
+{
+  if(!writer)
+    return;
+  if(length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS;
+
+  //No ArtSync for too long, the controller stopped synchronizing.
+  if(synchronous && (millis() - lastSync) > ARTNET_SHM_SYNC_TIMEOUT)
+  {
+    commit();
+    synchronous = false;
+  }
+
+  struct shmUniverse_s *u = lookup(universe, true);
+  if(!u)
+    return;
+
+  if(!synchronous)
+  {
+    shmWriteBegin(&header->sequence);
+    publish(u, length, sequence, data, header->frame + 1);
+    header->frame++;
+    header->synchronous = 0;
+    shmWriteEnd(&header->sequence);
+    return;
+  }
+
+  uint16_t i = u - slots;
+  memcpy(staged[i], data, length);
+  stagedLength[i] = length;
+  stagedSequence[i] = sequence;
+  pending[i >> 5] |= 1UL << (i & 31);
+}
+
+// **** Function ArtnetShm::sync() ****
+// Descr: Publishes all staged universes as one frame. Called by Artnet::read() for every ArtSync once attached.
+void ArtnetShm::sync()
+{
+  if(!writer)
+    return;
+
+  lastSync = millis();
+  synchronous = true;
+  commit();
+}
+
+// **** Function ArtnetShm::commit() ****
+// Descr: Publishes the staged universes under the frame seqlock, so readers see all of them or none.
+void ArtnetShm::commit()
+{
+  bool any = false;
+  for(uint16_t w=0 ; w < sizeof(pending) / sizeof(pending[0]) ; w++)
+    any |= (pending[w] != 0);
+  if(!any)
+    return;
+
+  uint32_t frame = header->frame + 1;
+  shmWriteBegin(&header->sequence);
+  for(uint16_t w=0 ; w < sizeof(pending) / sizeof(pending[0]) ; w++)
+  {
+    while(pending[w])
+    {
+      uint16_t i = (w << 5) + __builtin_ctz(pending[w]);
+      pending[w] &= pending[w] - 1;
+      publish(&slots[i], stagedLength[i], stagedSequence[i], staged[i], frame);
+    }
+  }
+  header->frame = frame;
+  header->synchronous = 1;
+  shmWriteEnd(&header->sequence);
+}
+
+#endif
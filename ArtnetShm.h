@@ -0,0 +1,147 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Shared memory frame export (Linux host only).
+// Publishes the received universes in a POSIX shared memory region, so any number of local processes (pixel driver,
+// visualiser, logger, ...) can map it and read the live frames without sockets, parsing, copies or syscalls.
+// Every universe slot and the frame as a whole are guarded by a seqlock: the writer makes the sequence odd while it
+// writes, a reader retries when the sequence was odd or changed during its read.
+// Without ArtSync every ArtDmx is published (and counted as a frame) on arrival. Once ArtSync is seen the universes
+// are staged and all of them are published together, as one frame, on the next ArtSync. Like a node the export falls
+// back to immediate publishing when no ArtSync was seen for ARTNET_SHM_SYNC_TIMEOUT ms.
+//
+// Reading a universe in place:
+//     const struct shmUniverse_s *u = reader.find(1);
+//     uint32_t s;
+//     do {
+//       s = ArtnetShm::beginRead(&u->sequence);
+//       ... use u->data and u->length ...
+//     } while(!ArtnetShm::endRead(&u->sequence, s));
+// Reading several universes of the same frame works the same way with the sequence of the header.
+//
+// Older glibc versions need -lrt for shm_open().
+
+#ifndef ARTNET_SHM_H
+#define ARTNET_SHM_H
+
+// Included from Artnet.h
+
+#if defined(ARTNET_HOST)
+
+#ifndef ARTNET_SHM_UNIVERSES
+    #define ARTNET_SHM_UNIVERSES    64          // Universe slots in the region, must be a power of 2.
+#endif
+#define   ARTNET_SHM_NAME           "/artnet"   // Default shared memory object, /dev/shm/artnet.
+#define   ARTNET_SHM_MAGIC          0x4D534E41  // "ANSM"
+#define   ARTNET_SHM_VERSION        1
+#define   ARTNET_SHM_SYNC_TIMEOUT   4000        // ms without ArtSync before publishing on arrival again.
+
+struct shmHeader_s {
+  uint32_t    magic;
+  uint16_t    version;
+  uint16_t    universes;                      //Number of universe slots following the header.
+  uint32_t    slotSize;                       //sizeof(struct shmUniverse_s)
+  uint32_t    sequence;                       //Frame seqlock, odd while a frame is being published.
+  uint32_t    frame;                          //Number of published frames.
+  uint8_t     synchronous;                    //1 when the last frame was published by ArtSync.
+} __attribute__((aligned(64)));
+
+struct shmUniverse_s {
+  uint32_t    sequence;                       //Seqlock of this slot, odd while it is being written.
+  uint16_t    universe;                       //15 bit Port-Address.
+  uint16_t    used;                           //Set once universe is valid, slots are never released.
+  uint16_t    length;                         //Number of valid bytes in data[].
+  uint8_t     artSequence;                    //Sequence number of the ArtDmx the data came from.
+  uint32_t    frame;                          //Frame the data was published in.
+  uint32_t    time;                           //millis() of the publication.
+  uint8_t     data[ARTNET_DMX_CHANNELS];
+} __attribute__((aligned(64)));
+
+class ArtnetShm
+{
+  public:
+    ArtnetShm();
+    ~ArtnetShm();
+
+    uint8_t  begin(const char *name = ARTNET_SHM_NAME);
+    uint8_t  open(const char *name = ARTNET_SHM_NAME);
+    void     end(void);
+    void     update(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *data);
+    void     sync(void);
+    const struct shmUniverse_s* find(uint16_t universe);
+
+    // **** Function ArtnetShm::getHeader() ****
+    // Descr: Returns the header of the mapped region, NULL when nothing is mapped.
+    inline const struct shmHeader_s* getHeader(void)
+    {
+      return header;
+    }
+
+    // **** Function ArtnetShm::beginRead() ****
+    // Descr: Starts a read guarded by the seqlock sequence, waits while a write is in progress.
+    // Return: the value to pass to endRead().
+    static inline uint32_t beginRead(const uint32_t *sequence)
+    {
+      uint32_t s;
+      while((s = __atomic_load_n(sequence, __ATOMIC_ACQUIRE)) & 1)
+        ;
+      return s;
+    }
+
+    // **** Function ArtnetShm::endRead() ****
+    // Descr: Ends a read started with beginRead().
+    // Return: true when the data read was consistent, false when it changed meanwhile and the read must be retried.
+    static inline bool endRead(const uint32_t *sequence, uint32_t s)
+    {
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      return __atomic_load_n(sequence, __ATOMIC_RELAXED) == s;
+    }
+
+  private:
+    ArtnetShm(const ArtnetShm&);
+    ArtnetShm& operator=(const ArtnetShm&);
+
+    struct shmHeader_s   *header;
+    struct shmUniverse_s *slots;
+    size_t    size;                           //Size of the mapping.
+    bool      writer;
+
+    //Writer side, kept in process memory until ArtSync publishes them.
+    uint8_t   staged[ARTNET_SHM_UNIVERSES][ARTNET_DMX_CHANNELS];
+    uint16_t  stagedLength[ARTNET_SHM_UNIVERSES];
+    uint8_t   stagedSequence[ARTNET_SHM_UNIVERSES];
+    uint32_t  pending[ARTNET_SHM_UNIVERSES / 32 + 1];     //Bitmap of staged slots.
+    bool      synchronous;
+    uint32_t  lastSync;
+
+    struct shmUniverse_s* lookup(uint16_t universe, bool create);
+    void     publish(struct shmUniverse_s *u, uint16_t length, uint8_t sequence, const uint8_t *data, uint32_t frame);
+    void     commit(void);
+};
+
+#endif
+
+#endif
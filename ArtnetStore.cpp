@@ -0,0 +1,111 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+// **** Function artnetCrc16() ****
+// Descr: CRC-16/CCITT (poly 0x1021, init 0xFFFF) used to validate the stored record.
+uint16_t artnetCrc16(const uint8_t *data, uint16_t size)
+{
+  uint16_t crc = 0xFFFF;
+  for(uint16_t i=0 ; i < size ; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for(uint8_t b=0 ; b < 8 ; b++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+// **** Function ArtnetStore::begin() ****
+// Descr: Prepares the backend to hold a record of size bytes at the given address (EEPROM offset, ignored for files).
+// Return: 1 = storage available ; 0 = no storage on this platform.
+uint8_t ArtnetStore::begin(uint16_t address, uint16_t size)
+{
+  this->address = address;
+  this->size = size;
+
+  #if !ARTNET_STORE_SUPPORTED
+    return 0;
+  #elif defined(ARTNET_STORE_FILE)
+    return 1;
+  #elif defined(ESP8266) || defined(ESP32)
+    //The ESP cores emulate EEPROM in a flash sector that is mirrored in RAM.
+    EEPROM.begin(address + size);
+    return 1;
+  #else
+    return (address + size <= EEPROM.length()) ? 1 : 0;
+  #endif
+}
+
+// **** Function ArtnetStore::read() ****
+// Descr: Reads the raw record into data. The caller has to validate its content.
+// Return: 1 = success ; 0 = nothing could be read.
+uint8_t ArtnetStore::read(uint8_t *data)
+{
+  #if !ARTNET_STORE_SUPPORTED
+    return 0;
+  #elif defined(ARTNET_STORE_FILE)
+    FILE *f = fopen(ARTNET_STORE_PATH, "rb");
+    if(!f)
+      return 0;
+    size_t n = fread(data, 1, size, f);
+    fclose(f);
+    return (n == size) ? 1 : 0;
+  #else
+    for(uint16_t i=0 ; i < size ; i++)
+      data[i] = EEPROM.read(address + i);
+    return 1;
+  #endif
+}
+
+// **** Function ArtnetStore::write() ****
+// Descr: Writes the record. Only bytes that differ from what is stored are programmed, to spare the EEPROM/flash cells.
+// Return: 1 = success ; 0 = write failed.
+uint8_t ArtnetStore::write(const uint8_t *data)
+{
+  #if !ARTNET_STORE_SUPPORTED
+    return 0;
+  #elif defined(ARTNET_STORE_FILE)
+    //Write to a temporary file first so a power cut never leaves a half written record behind.
+    FILE *f = fopen(ARTNET_STORE_PATH ".tmp", "wb");
+    if(!f)
+      return 0;
+    size_t n = fwrite(data, 1, size, f);
+    if(fclose(f) != 0 || n != size)
+      return 0;
+    return (rename(ARTNET_STORE_PATH ".tmp", ARTNET_STORE_PATH) == 0) ? 1 : 0;
+  #elif defined(ESP8266) || defined(ESP32)
+    //write() only marks the sector dirty when a byte actually changes, commit() skips clean sectors.
+    for(uint16_t i=0 ; i < size ; i++)
+      EEPROM.write(address + i, data[i]);
+    return EEPROM.commit() ? 1 : 0;
+  #else
+    for(uint16_t i=0 ; i < size ; i++)
+      EEPROM.update(address + i, data[i]);
+    return 1;
+  #endif
+}
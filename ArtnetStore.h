@@ -0,0 +1,86 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#ifndef ARTNET_STORE_H
+#define ARTNET_STORE_H
+
+// Included from Artnet.h, it relies on the node definitions made there.
+
+// *** Persistent storage backend
+//   ARTNET_STORE_FILE defined  -> the record is kept in a file (hosts, or MCUs with a mounted filesystem).
+//   ARDUINO_SAMD_ZERO          -> no EEPROM emulation available, storage is disabled.
+//   all other boards           -> EEPROM (Teensy, AVR, ESP8266 and ESP32 flash emulated EEPROM).
+#if defined(ARTNET_STORE_FILE)
+    #define ARTNET_STORE_SUPPORTED  true
+    #ifndef ARTNET_STORE_PATH
+        #define ARTNET_STORE_PATH   "artnet-node.cfg"
+    #endif
+#elif defined(ARDUINO_SAMD_ZERO)   //UNTESTED! Would need the FlashStorage library.
+    #define ARTNET_STORE_SUPPORTED  false
+#else
+    #include <EEPROM.h>
+    #define ARTNET_STORE_SUPPORTED  true
+#endif
+
+#ifndef ARTNET_STORE_ADDR
+    #define ARTNET_STORE_ADDR       0           // Default EEPROM offset of the stored record.
+#endif
+#define   ARTNET_STORE_MAGIC        0x4E41      // 'A' 'N'
+#define   ARTNET_STORE_LAYOUT       1           // Bump this when store_s changes, old records are then ignored.
+#define   ARTNET_STORE_DELAY        2000        // ms the configuration must be stable before it is written.
+#define   ARTNET_STORE_LEASE        0x01        // flags: the lease fields hold the last DHCP lease.
+
+// Image of the node configuration as it is kept in EEPROM/flash.
+// Only fields that are programmed by the user or the controller are part of it, counters and status are not.
+struct store_s {
+  uint16_t    magic;
+  uint8_t     layout;
+  uint8_t     flags;
+  uint8_t     shortname[18];
+  uint8_t     longname[64];
+  uint16_t    universe[ART_NUM_UNIVERSES][ART_UNIVERSE_PARAMS];
+  uint8_t     ip[4];                          //Last leased IP address.
+  uint8_t     subnet[4];
+  uint8_t     gateway[4];
+  uint8_t     dns[4];
+  uint16_t    crc;                            //CRC16 over all the fields above.
+};
+
+uint16_t artnetCrc16(const uint8_t *data, uint16_t size);
+
+class ArtnetStore
+{
+  public:
+    uint8_t begin(uint16_t address, uint16_t size);
+    uint8_t read(uint8_t *data);
+    uint8_t write(const uint8_t *data);
+
+  private:
+    uint16_t  address;
+    uint16_t  size;
+};
+
+#endif
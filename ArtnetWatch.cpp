@@ -0,0 +1,166 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Credit: Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+#include <Artnet.h>
+
+ArtnetWatch::ArtnetWatch()
+{
+  memset(universes, 0, sizeof(universes));
+  memset(ranges, 0, sizeof(ranges));
+}
+
+// **** Function ArtnetWatch::subscribe() ****
+// Descr: Calls fptr whenever a channel in [start, start+length) of universe changes.
+// Argumenets: universe = 15 bit Port-Address, start = first channel (0 based, as data[] in the ArtDmx callback), length = number of channels.
+//             fptr = callback, it gets the changed span (rounded to groups of 4 channels) with data pointing at channel start.
+// Return: subscription id, -1 when all ranges or universe slots are in use.
+int8_t ArtnetWatch::subscribe(uint16_t universe, uint16_t start, uint16_t length, void (*fptr)(uint8_t id, uint16_t universe, uint16_t start, uint16_t length, uint8_t* data))
+{
+  if(start >= ARTNET_DMX_CHANNELS || length == 0 || !fptr)
+    return -1;
+  if(start + length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS - start;
+
+  int8_t id = -1;
+  for(uint8_t i=0 ; i < ARTNET_WATCH_RANGES && id < 0 ; i++)
+    if(!ranges[i].callback)
+      id = i;
+
+  //Share the slot of a universe that is already watched, otherwise take a free one.
+  int8_t slot = -1;
+  for(uint8_t i=0 ; i < ARTNET_WATCH_UNIVERSES && slot < 0 ; i++)
+    if(universes[i].subscribers && universes[i].universe == universe)
+      slot = i;
+  for(uint8_t i=0 ; i < ARTNET_WATCH_UNIVERSES && slot < 0 ; i++)
+    if(!universes[i].subscribers)
+      slot = i;
+
+  if(id < 0 || slot < 0)
+    return -1;
+
+  if(!universes[slot].subscribers)
+  {
+    universes[slot].universe = universe;
+    universes[slot].valid = false;
+  }
+  universes[slot].subscribers++;
+
+  ranges[id].slot = slot;
+  ranges[id].start = start;
+  ranges[id].end = start + length;
+  ranges[id].callback = fptr;
+  return id;
+}
+
+// **** Function ArtnetWatch::unsubscribe() ****
+// Descr: Removes a subscription, the universe slot is released with its last subscriber.
+void ArtnetWatch::unsubscribe(int8_t id)
+{
+  if(id < 0 || id >= ARTNET_WATCH_RANGES || !ranges[id].callback)
+    return;
+
+  universes[ranges[id].slot].subscribers--;
+  ranges[id].callback = NULL;
+}
+
+// **** Function ArtnetWatch::invalidate() ****
+// Descr: Forgets the stored frames, the next frame of every universe calls all its subscriptions. Use it after the outputs were cleared.
+void ArtnetWatch::invalidate()
+{
+  for(uint8_t i=0 ; i < ARTNET_WATCH_UNIVERSES ; i++)
+    universes[i].valid = false;
+}
+
+// **** Function ArtnetWatch::update() ****
+// Descr: Compares a received frame with the previous one of its universe and calls the subscriptions that changed.
+//        Called by Artnet::read() for every ArtDmx packet once the watch is attached with Artnet::setWatch().
+// Return: number of callbacks that were called.
+uint8_t ArtnetWatch::update(uint16_t universe, uint16_t length, uint8_t *data)
+{
+  struct watchUniverse_s *w = NULL;
+  uint8_t slot;
+  for(slot=0 ; slot < ARTNET_WATCH_UNIVERSES ; slot++)
+  {
+    if(universes[slot].subscribers && universes[slot].universe == universe)
+    {
+      w = &universes[slot];
+      break;
+    }
+  }
+  if(!w || length == 0)
+    return 0;
+  if(length > ARTNET_DMX_CHANNELS)
+    length = ARTNET_DMX_CHANNELS;
+
+  //Whole frame check first: on static scenes the frame is identical and this is the only work done.
+  if(w->valid && memcmp(w->frame, data, length) == 0)
+    return 0;
+
+  //Word wide compare, the dirty bitmap holds one bit per 4 channels.
+  uint32_t dirty[ARTNET_DMX_WORDS / 32] = {0};
+  uint16_t words = (length + 3) / 4;
+  for(uint16_t i=0 ; i < words ; i++)
+  {
+    uint32_t v = w->frame[i];                                 //Channels beyond length keep their value.
+    uint16_t n = (length - i * 4 < 4) ? length - i * 4 : 4;
+    memcpy(&v, data + i * 4, n);                              //data is not word aligned in the Art-Net packet.
+    if(!w->valid || v != w->frame[i])
+    {
+      w->frame[i] = v;
+      dirty[i >> 5] |= (uint32_t)1 << (i & 31);
+    }
+  }
+  w->valid = true;
+
+  uint8_t called = 0;
+  for(uint8_t id=0 ; id < ARTNET_WATCH_RANGES ; id++)
+  {
+    struct watchRange_s *r = &ranges[id];
+    if(!r->callback || r->slot != slot || r->start >= length)
+      continue;
+
+    uint16_t last = ((r->end < length) ? r->end : length) - 1;
+    int16_t first = -1, final = -1;
+    for(uint16_t i = r->start / 4 ; i <= last / 4 ; i++)
+    {
+      if(dirty[i >> 5] & ((uint32_t)1 << (i & 31)))
+      {
+        if(first < 0)
+          first = i;
+        final = i;
+      }
+    }
+    if(first < 0)
+      continue;
+
+    //Clip the dirty words to the subscribed range.
+    uint16_t spanStart = (first * 4 > r->start) ? first * 4 : r->start;
+    uint16_t spanEnd = (final * 4 + 3 < last) ? final * 4 + 3 : last;
+    (*r->callback)(id, universe, spanStart, spanEnd - spanStart + 1, data + spanStart);
+    called++;
+  }
+  return called;
+}
@@ -0,0 +1,74 @@
+/*The MIT License (MIT)
+
+Copyright (c) 2020 Mathieu Hebbrecht
+https://github.com/MathieuMH, https://www.thieu.gent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/* Art-Net™ Designed by and Copyright Artistic Licence Holdings Ltd */
+
+// Change detection on channel ranges.
+// Subscribe a callback to a channel range (e.g. a fixture footprint) of a universe. Every ArtDmx frame is compared
+// with the previous one of that universe and only subscriptions with changed channels are called, with the changed span.
+// Consoles refresh static looks continuously, so on static scenes no callback fires at all.
+
+#ifndef ARTNET_WATCH_H
+#define ARTNET_WATCH_H
+
+// Included from Artnet.h
+
+#ifndef ARTNET_WATCH_UNIVERSES
+    #define ARTNET_WATCH_UNIVERSES  ART_NUM_UNIVERSES   // Universes that keep a copy of their last frame (512 bytes each).
+#endif
+#ifndef ARTNET_WATCH_RANGES
+    #define ARTNET_WATCH_RANGES     16                  // Maximum number of subscriptions.
+#endif
+#define   ARTNET_DMX_WORDS          (ARTNET_DMX_CHANNELS / 4)
+
+class ArtnetWatch
+{
+  public:
+    ArtnetWatch();
+
+    int8_t  subscribe(uint16_t universe, uint16_t start, uint16_t length, void (*fptr)(uint8_t id, uint16_t universe, uint16_t start, uint16_t length, uint8_t* data));
+    void    unsubscribe(int8_t id);
+    uint8_t update(uint16_t universe, uint16_t length, uint8_t *data);
+    void    invalidate(void);
+
+  private:
+    struct watchUniverse_s {
+      uint16_t  universe;
+      uint16_t  subscribers;                //0 = slot free.
+      bool      valid;                      //False until the first frame was received, that frame is all dirty.
+      uint32_t  frame[ARTNET_DMX_WORDS];    //Last accepted DMX data, word aligned.
+    };
+
+    struct watchRange_s {
+      uint8_t   slot;                       //Index in universes[].
+      uint16_t  start;
+      uint16_t  end;                        //First channel after the range.
+      void    (*callback)(uint8_t id, uint16_t universe, uint16_t start, uint16_t length, uint8_t* data);
+    };
+
+    struct watchUniverse_s universes[ARTNET_WATCH_UNIVERSES];
+    struct watchRange_s ranges[ARTNET_WATCH_RANGES];
+};
+
+#endif
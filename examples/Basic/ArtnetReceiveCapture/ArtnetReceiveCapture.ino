@@ -0,0 +1,55 @@
+/*
+This example keeps a black-box capture of the received packets while running as a normal node.
+When an ArtDmx sequence number is skipped, or when 't' is sent over Serial, the capture freezes shortly after and
+is printed. Send 'a' to arm it again.
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include <SPI.h>
+
+Artnet artnet;
+ArtnetCapture capture;
+
+//Set broadcast and mac address according to your setup.
+byte broadcast[] = {192, 255, 255, 255};
+byte mac[] = {0x04, 0xE9, 0xE5, 0x00, 0x69, 0xEC};
+
+void setup()
+{
+  Serial.begin(115200);
+  artnet.begin(mac);
+  artnet.setBroadcast(broadcast);
+
+  // Keep 8 more packets after the trigger, so the capture shows what happened before and after it.
+  capture.setTrigger(ARTNET_CAPTURE_ON_GAP, 8);
+  artnet.setCapture(&capture);
+}
+
+void loop()
+{
+  artnet.read();
+
+  if (Serial.available())
+  {
+    char c = Serial.read();
+    if (c == 't')
+      capture.trigger();
+    if (c == 'a')
+      capture.arm();
+  }
+
+  // Nothing is printed while the capture is running, so the node keeps its normal timing.
+  static bool printed = false;
+  if (capture.triggered() && !printed)
+  {
+    Serial.print("Capture triggered, sequence gaps: ");
+    Serial.println(capture.getGaps());
+    capture.dump(Serial);
+    printed = true;
+  }
+  if (!capture.triggered())
+    printed = false;
+}
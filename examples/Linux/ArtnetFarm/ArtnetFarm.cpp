@@ -0,0 +1,76 @@
+/*
+This example runs a farm of virtual Art-Net nodes on a Linux host, to load test consoles, switches and gateway software.
+Every node gets its own IP address, counting up from the first one, and ART_NUM_UNIVERSES consecutive universes.
+Use loopback addresses (127.0.1.1 and up) to test on one machine, or add alias IPs to an interface to test over the network:
+    for i in $(seq 1 200); do sudo ip addr add 10.0.1.$i/16 dev eth0; done
+
+Build from the library folder with:
+    g++ -O2 -I. *.cpp examples/Linux/ArtnetFarm/ArtnetFarm.cpp -o artnet-farm
+Run:
+    ./artnet-farm <nodes> <first ip> [first universe] [report interval in s]
+
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <ArtnetFarm.h>
+#include <signal.h>
+
+ArtnetFarm farm;
+volatile sig_atomic_t running = 1;
+
+void onSignal(int)
+{
+  running = 0;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    printf("usage: %s <nodes> <first ip> [first universe] [report interval in s]\n", argv[0]);
+    return 1;
+  }
+
+  int numNodes = atoi(argv[1]);
+  unsigned int ip[4];
+  if (numNodes <= 0 || sscanf(argv[2], "%u.%u.%u.%u", &ip[0], &ip[1], &ip[2], &ip[3]) != 4)
+  {
+    printf("invalid arguments\n");
+    return 1;
+  }
+  int startUniverse = (argc > 3) ? atoi(argv[3]) : 0;
+  uint32_t interval = (argc > 4) ? atoi(argv[4]) * 1000 : 5000;
+
+  if (!farm.begin(numNodes))
+  {
+    perror("could not open the Art-Net port");
+    return 1;
+  }
+
+  // Count the node addresses up from the first one
+  uint32_t address = (ip[0] << 24) | (ip[1] << 16) | (ip[2] << 8) | ip[3];
+  for (int i = 0 ; i < numNodes ; i++)
+  {
+    uint32_t a = address + i;
+    byte nodeIP[] = {(byte)(a >> 24), (byte)(a >> 16), (byte)(a >> 8), (byte)a};
+    farm.addNode(nodeIP, startUniverse + i * ART_NUM_UNIVERSES);
+  }
+  printf("%d nodes running, universes %d to %d\n", numNodes, startUniverse, startUniverse + numNodes * ART_NUM_UNIVERSES - 1);
+
+  signal(SIGINT, onSignal);
+  uint32_t lastReport = millis();
+  while (running)
+  {
+    // drain the socket, then sleep a little when it is empty
+    if (!farm.read())
+      delay(1);
+
+    if (millis() - lastReport >= interval)
+    {
+      farm.printReport();
+      lastReport = millis();
+    }
+  }
+  return 0;
+}
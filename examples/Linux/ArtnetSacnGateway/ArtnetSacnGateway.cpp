@@ -0,0 +1,60 @@
+/*
+This example turns a Linux host into an Art-Net to sACN (E1.31) gateway.
+Every ArtDmx universe received is sent on as sACN universe + 1 to its multicast group, ArtSync is sent on as an
+E1.31 synchronization packet when a sync universe is given.
+
+Build from the library folder with:
+    g++ -O2 -I. *.cpp examples/Linux/ArtnetSacnGateway/ArtnetSacnGateway.cpp -o artnet-sacn
+Run:
+    ./artnet-sacn [sync universe] [unicast ip]
+
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <signal.h>
+
+Artnet artnet;
+ArtnetSacn sacn;
+volatile sig_atomic_t running = 1;
+
+// The mac address is only used to derive the sACN CID
+byte mac[] = {0x02, 0x00, 0x00, 0x00, 0x53, 0x41};
+
+void onSignal(int)
+{
+  running = 0;
+}
+
+int main(int argc, char *argv[])
+{
+  if (!artnet.begin(mac))
+  {
+    printf("no network interface found\n");
+    return 1;
+  }
+  if (!sacn.begin(mac, "Art-Net gateway"))
+  {
+    perror("could not open the sACN port");
+    return 1;
+  }
+
+  if (argc > 1)
+    sacn.setSyncAddress(atoi(argv[1]));
+
+  unsigned int ip[4];
+  if (argc > 2 && sscanf(argv[2], "%u.%u.%u.%u", &ip[0], &ip[1], &ip[2], &ip[3]) == 4)
+    sacn.setUnicast(IPAddress(ip[0], ip[1], ip[2], ip[3]));
+
+  // ArtDmx and ArtSync accepted by read() are forwarded by the gateway
+  artnet.setGateway(&sacn);
+
+  signal(SIGINT, onSignal);
+  while (running)
+  {
+    // drain the socket, then sleep a little when it is empty
+    if (!artnet.read())
+      delay(1);
+  }
+  return 0;
+}
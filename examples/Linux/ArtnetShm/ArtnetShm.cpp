@@ -0,0 +1,97 @@
+/*
+This example publishes the received universes in shared memory (/dev/shm/artnet) and shows how an other process
+reads them. Start the node, then any number of readers:
+    ./artnet-shm
+    ./artnet-shm read 0
+A reader prints the first channels of a universe every time a new frame of it was published.
+
+Build from the library folder with:
+    g++ -O2 -I. *.cpp examples/Linux/ArtnetShm/ArtnetShm.cpp -o artnet-shm
+
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <signal.h>
+
+Artnet artnet;
+ArtnetShm shm;
+volatile sig_atomic_t running = 1;
+
+byte mac[] = {0x02, 0x00, 0x00, 0x00, 0x53, 0x4D};
+
+void onSignal(int)
+{
+  running = 0;
+}
+
+int node()
+{
+  if (!artnet.begin(mac))
+  {
+    printf("no network interface found\n");
+    return 1;
+  }
+  if (!shm.begin())
+  {
+    perror("could not create the shared memory");
+    return 1;
+  }
+  artnet.setShm(&shm);
+
+  while (running)
+  {
+    if (!artnet.read())
+      delay(1);
+  }
+  return 0;
+}
+
+int reader(uint16_t universe)
+{
+  if (!shm.open())
+  {
+    printf("no shared memory found, is the node running?\n");
+    return 1;
+  }
+
+  uint32_t lastFrame = 0;
+  while (running)
+  {
+    const struct shmUniverse_s *u = shm.find(universe);
+    if (!u)
+    {
+      delay(100);
+      continue;
+    }
+
+    // Copy out what is needed, retry when the node published meanwhile.
+    uint8_t first[8];
+    uint32_t frame, s;
+    uint16_t length;
+    do
+    {
+      s = ArtnetShm::beginRead(&u->sequence);
+      frame = u->frame;
+      length = u->length;
+      memcpy(first, u->data, sizeof(first));
+    } while (!ArtnetShm::endRead(&u->sequence, s));
+
+    if (frame != lastFrame)
+    {
+      printf("frame %u universe %u length %u: %u %u %u %u %u %u %u %u\n", frame, universe, length,
+             first[0], first[1], first[2], first[3], first[4], first[5], first[6], first[7]);
+      lastFrame = frame;
+    }
+    delay(1);
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  signal(SIGINT, onSignal);
+  if (argc > 2 && strcmp(argv[1], "read") == 0)
+    return reader(atoi(argv[2]));
+  return node();
+}
@@ -0,0 +1,170 @@
+/*
+This example records a timecoded show from the network and plays it back chased by ArtTimeCode.
+Record: while the console runs timecode, every change of the listed universes is stored with the time it happened.
+    ./artnet-show record show.bin 0 1 2 3
+Play: the node outputs the recorded frames following the timecode, no ArtDmx is needed.
+    ./artnet-show play show.bin
+The show file can also be stored on an SD card or in flash for ArtnetCue on a board, see ArtnetCue.h for its layout.
+
+Build from the library folder with:
+    g++ -O2 -I. *.cpp examples/Linux/ArtnetShow/ArtnetShow.cpp -o artnet-show
+
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <signal.h>
+#include <vector>
+
+Artnet artnet;
+ArtnetCue cue;
+volatile sig_atomic_t running = 1;
+
+byte mac[] = {0x02, 0x00, 0x00, 0x00, 0x53, 0x48};
+
+// Recording
+std::vector<uint16_t> universes;
+std::vector<uint8_t> live;                  // Latest data of every listed universe.
+std::vector<uint8_t> frames;                // Recorded frames, one after the other.
+std::vector<uint32_t> timeIndex;            // Pairs of time and frame offset.
+bool changed = false;
+
+void onSignal(int)
+{
+  running = 0;
+}
+
+void put16(std::vector<uint8_t> &v, uint16_t n)
+{
+  v.push_back(n);
+  v.push_back(n >> 8);
+}
+
+void put32(std::vector<uint8_t> &v, uint32_t n)
+{
+  put16(v, n);
+  put16(v, n >> 16);
+}
+
+void onDmx(uint16_t universe, uint16_t length, uint8_t /*sequence*/, uint8_t* data, IPAddress /*remoteIP*/)
+{
+  for (size_t i = 0; i < universes.size(); i++)
+  {
+    if (universes[i] != universe)
+      continue;
+    if (length > ARTNET_DMX_CHANNELS)
+      length = ARTNET_DMX_CHANNELS;
+    uint8_t *frame = &live[i * ARTNET_DMX_CHANNELS];
+    if (memcmp(frame, data, length) != 0)
+    {
+      memcpy(frame, data, length);
+      changed = true;
+    }
+  }
+}
+
+void onTimeCodeRecord(struct timecode_s *tc, IPAddress /*remoteIP*/)
+{
+  int32_t time = ArtnetCue::timecodeToMillis(tc);
+  if (time < 0 || !changed)
+    return;
+  // The index must be sorted, timecode running backwards is not recorded.
+  if (!timeIndex.empty() && (uint32_t)time <= timeIndex[timeIndex.size() - 2])
+    return;
+
+  timeIndex.push_back(time);
+  timeIndex.push_back(frames.size());
+  frames.insert(frames.end(), live.begin(), live.end());
+  changed = false;
+  printf("%02u:%02u:%02u:%02u entry %zu\n", tc->hours, tc->minutes, tc->seconds, tc->frames, timeIndex.size() / 2);
+}
+
+int record(const char *path)
+{
+  artnet.setArtDmxCallback(onDmx);
+  artnet.setArtTimeCodeCallback(onTimeCodeRecord);
+  while (running)
+  {
+    if (!artnet.read())
+      delay(1);
+  }
+
+  // Header, universe list, index and frames
+  std::vector<uint8_t> show;
+  uint32_t entries = timeIndex.size() / 2;
+  uint32_t dataStart = ARTNET_CUE_HEADER + 2 * universes.size() + ARTNET_CUE_ENTRY * entries;
+  put32(show, ARTNET_CUE_MAGIC);
+  show.push_back(ARTNET_CUE_VERSION);
+  show.push_back(0);
+  put16(show, universes.size());
+  put32(show, entries);
+  put16(show, ARTNET_DMX_CHANNELS);
+  put16(show, 0);
+  for (size_t i = 0; i < universes.size(); i++)
+    put16(show, universes[i]);
+  for (uint32_t i = 0; i < entries; i++)
+  {
+    put32(show, timeIndex[2 * i]);
+    put32(show, dataStart + timeIndex[2 * i + 1]);
+  }
+  show.insert(show.end(), frames.begin(), frames.end());
+
+  FILE *f = fopen(path, "wb");
+  if (!f || fwrite(show.data(), 1, show.size(), f) != show.size() || fclose(f) != 0)
+  {
+    perror("could not write the show");
+    return 1;
+  }
+  printf("%u entries written to %s\n", entries, path);
+  return 0;
+}
+
+int play(const char *path)
+{
+  if (!cue.begin(path))
+  {
+    printf("%s is not a show file\n", path);
+    return 1;
+  }
+  artnet.setCue(&cue);
+
+  int32_t shown = -1;
+  while (running)
+  {
+    uint16_t r = artnet.read();
+    if (!r)
+      delay(1);
+
+    if (r == ART_TIME_CODE && cue.getEntry() != shown)
+    {
+      struct timecode_s tc = artnet.getTimeCode();
+      shown = cue.getEntry();
+      printf("%02u:%02u:%02u:%02u entry %d\n", tc.hours, tc.minutes, tc.seconds, tc.frames, shown);
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3 || (strcmp(argv[1], "record") == 0 && argc < 4))
+  {
+    printf("usage: %s record <show file> <universe>...\n       %s play <show file>\n", argv[0], argv[0]);
+    return 1;
+  }
+  if (!artnet.begin(mac))
+  {
+    printf("no network interface found\n");
+    return 1;
+  }
+  signal(SIGINT, onSignal);
+
+  if (strcmp(argv[1], "record") == 0)
+  {
+    for (int i = 3; i < argc; i++)
+      universes.push_back(atoi(argv[i]));
+    live.resize(universes.size() * ARTNET_DMX_CHANNELS);
+    return record(argv[2]);
+  }
+  return play(argv[2]);
+}
@@ -0,0 +1,69 @@
+/*
+This example will receive one universe via Artnet and control a strip of ws2811 leds via
+Adafruit's NeoPixel library: https://github.com/Adafruit/Adafruit_NeoPixel
+The strip is split in segments (think of them as fixtures). Each segment subscribes to its channel range, so only
+segments whose channels changed are redrawn and the strip is only refreshed when something changed.
+This example may be copied under the terms of the MIT license, see the LICENSE file for details
+*/
+
+#include <Artnet.h>
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include <SPI.h>
+#include <Adafruit_NeoPixel.h>
+
+// Neopixel settings
+const int numLeds = 170; // one universe holds 170 RGB leds
+const int ledsPerSegment = 12; // change for your setup
+const byte dataPin = 2;
+Adafruit_NeoPixel leds = Adafruit_NeoPixel(numLeds, dataPin, NEO_GRB + NEO_KHZ800);
+
+// Artnet settings
+Artnet artnet;
+ArtnetWatch watch;
+const int universe = 0; // CHANGE FOR YOUR SETUP most software this is 1, some software send out artnet first universe as 0.
+bool changed = false;
+
+// Change ip and mac address for your setup
+byte ip[] = {192, 168, 2, 2};
+byte mac[] = {0x04, 0xE9, 0xE5, 0x00, 0x69, 0xEC};
+
+void setup()
+{
+  artnet.begin(mac, ip);
+  leds.begin();
+  leds.show();
+
+  // one subscription per segment, ARTNET_WATCH_RANGES limits the number of segments
+  for (int led = 0 ; led < numLeds ; led += ledsPerSegment)
+  {
+    int length = (numLeds - led < ledsPerSegment) ? numLeds - led : ledsPerSegment;
+    watch.subscribe(universe, led * 3, length * 3, onSegmentChange);
+  }
+  artnet.setWatch(&watch);
+}
+
+void loop()
+{
+  // we call the read function inside the loop
+  artnet.read();
+
+  if (changed)
+  {
+    leds.show();
+    changed = false;
+  }
+}
+
+// called with the changed part of a segment only, start is the first changed channel
+void onSegmentChange(uint8_t id, uint16_t universe, uint16_t start, uint16_t length, uint8_t* data)
+{
+  // align the span to whole leds
+  int first = start / 3;
+  int last = (start + length - 1) / 3;
+  data -= start - first * 3;
+
+  for (int led = first ; led <= last ; led++, data += 3)
+    leds.setPixelColor(led, data[0], data[1], data[2]);
+  changed = true;
+}
@@ -1,6 +1,9 @@
 /*
 This example will receive multiple universes via Artnet and control a strip of ws2811 leds via
 Paul Stoffregen's excellent OctoWS2811 library: https://www.pjrc.com/teensy/td_libs_OctoWS2811.html
+The received data is copied into one RGB buffer by a compiled ArtnetPatch (170 leds per universe) and written to the
+OctoWS2811 drawing memory in one go by ArtnetOcto, instead of calling setPixel() for every led. This uses the Teensy 3.x
+layout of OctoWS2811.
 This example may be copied under the terms of the MIT license, see the LICENSE file for details
 */
 
@@ -19,6 +22,9 @@ DMAMEM int displayMemory[ledsPerStrip*6];
 int drawingMemory[ledsPerStrip*6];
 const int config = WS2811_GRB | WS2811_800kHz;
 OctoWS2811 leds(ledsPerStrip, displayMemory, drawingMemory, config);
+ArtnetOcto octo;
+ArtnetPatch patch;
+byte rgb[numberOfChannels]; // all strips one after the other, as received
 
 // Artnet settings
 Artnet artnet;
@@ -28,7 +34,6 @@ const int startUniverse = 0; // CHANGE FOR YOUR SETUP most software this is 1, s
 const int maxUniverses = numberOfChannels / 512 + ((numberOfChannels % 512) ? 1 : 0);
 bool universesReceived[maxUniverses];
 bool sendFrame = 1;
-int previousDataLength = 0;
 
 // Change ip and mac address for your setup
 byte ip[] = {192, 168, 2, 2};
@@ -41,16 +46,32 @@ void setup()
   artnet.setBroadcast(broadcast);
   artnet.begin(mac, ip);
   leds.begin();
+  octo.begin(drawingMemory, ledsPerStrip, config);
+  for (int strip = 0 ; strip < numStrips ; strip++)
+    octo.setStrip(strip, rgb + strip * ledsPerStrip * 3);
+
+  // all leds are one contiguous run starting at startUniverse, the patch splits it at the universe boundaries
+  patch.begin(rgb, sizeof(rgb));
+  patch.addSegment(startUniverse, 0, numLeds, 0);
+  patch.compile();
   initTest();
 
-  // this will be called for each packet received
+  // ArtDmx packets are copied into rgb by the patch, the callback keeps track of the received universes
+  artnet.setPatch(&patch);
   artnet.setArtDmxCallback(onDmxFrame);
 }
 
 void loop()
 {
-  // we call the read function inside the loop
-  artnet.read();
+  // we call the read function inside the loop, the patch has copied the packet once it returns
+  if (artnet.read() == ART_DMX && sendFrame)
+  {
+    // transpose all strips into the drawing memory at once
+    octo.update();
+    leds.show();
+    // Reset universeReceived to 0
+    memset(universesReceived, 0, maxUniverses);
+  }
 }
 
 void onDmxFrame(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t* data, IPAddress remoteIP)
@@ -69,22 +90,6 @@ void onDmxFrame(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t* d
       break;
     }
   }
-
-  // read universe and put into the right part of the display buffer
-  for (int i = 0; i < length / 3; i++)
-  {
-    int led = i + (universe - startUniverse) * (previousDataLength / 3);
-    if (led < numLeds)
-      leds.setPixel(led, data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
-  }
-  previousDataLength = length;
-
-  if (sendFrame)
-  {
-    leds.show();
-    // Reset universeReceived to 0
-    memset(universesReceived, 0, maxUniverses);
-  }
 }
 
 void initTest()
@@ -1,6 +1,8 @@
 /*
 This example will receive multiple universes via Artnet and control a strip of ws2811 leds via
 Paul Stoffregen's excellent OctoWS2811 library: https://www.pjrc.com/teensy/td_libs_OctoWS2811.html
+Universes are mapped to the strips with a compiled ArtnetPatch (170 leds per universe, all strips one after the
+other) and the strips are written to OctoWS2811 with ArtnetOcto when the ArtSync arrives.
 This example may be copied under the terms of the MIT license, see the LICENSE file for details
 */
 
@@ -19,11 +21,15 @@ DMAMEM int displayMemory[ledsPerStrip*6];
 int drawingMemory[ledsPerStrip*6];
 const int config = WS2811_GRB | WS2811_800kHz;
 OctoWS2811 leds(ledsPerStrip, displayMemory, drawingMemory, config);
+ArtnetOcto octo;
+ArtnetPatch patch;
+byte rgb[numberOfChannels]; // all strips one after the other
 
 // Artnet settings
 Artnet artnet;
 const int startUniverse = 0; // CHANGE FOR YOUR SETUP most software this is 1, some software send out artnet first universe as 0.
-int previousDataLength = 0;
+const bool newUniversePerStrip = false; // true: every strip starts at channel 1 of a new universe
+const bool serpentineStrips = false; // true: odd strips are mounted in reverse
 
 // Change ip and mac address for your setup
 byte ip[] = {192, 168, 2, 2};
@@ -36,10 +42,31 @@ void setup()
   artnet.setBroadcast(broadcast);
   artnet.begin(mac, ip);
   leds.begin();
+  octo.begin(drawingMemory, ledsPerStrip, config);
+
+  patch.begin(rgb, sizeof(rgb));
+
+  // All leds are one contiguous run of 170 leds per universe starting at startUniverse, like the
+  // strips are chained one after the other. The patch splits the run at the universe boundaries.
+  if (!newUniversePerStrip && !serpentineStrips)
+    patch.addSegment(startUniverse, 0, numLeds, 0);
+  int universe = startUniverse;
+  for (int strip = 0 ; strip < numStrips ; strip++)
+  {
+    if (newUniversePerStrip || serpentineStrips)
+    {
+      // Optional layouts: a strip may start in its own universe and odd strips may be mounted in reverse
+      int first = newUniversePerStrip ? 0 : (strip * ledsPerStrip) % 170;
+      patch.addSegment(universe, first * 3, ledsPerStrip, strip * ledsPerStrip * 3, 3, 0, serpentineStrips && (strip % 2));
+      universe += newUniversePerStrip ? (ledsPerStrip + 169) / 170 : (first + ledsPerStrip) / 170;
+    }
+    octo.setStrip(strip, rgb + strip * ledsPerStrip * 3);
+  }
+  patch.compile();
   initTest();
 
-  // this will be called for each packet received
-  artnet.setArtDmxCallback(onDmxFrame);
+  // ArtDmx packets are copied into rgb by the patch, ArtSync shows them
+  artnet.setPatch(&patch);
   artnet.setArtSyncCallback(onSync);
 }
 
@@ -49,19 +76,8 @@ void loop()
   artnet.read();
 }
 
-void onDmxFrame(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t* data, IPAddress remoteIP)
-{
-  // read universe and put into the right part of the display buffer
-  for (int i = 0; i < length / 3; i++)
-  {
-    int led = i + (universe - startUniverse) * (previousDataLength / 3);
-    if (led < numLeds)
-      leds.setPixel(led, data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
-  }
-  previousDataLength = length;
-}
-
 void onSync(IPAddress remoteIP) {
+    octo.update();
     leds.show();
 }
 